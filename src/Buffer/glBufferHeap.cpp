@@ -0,0 +1,456 @@
+#include "Buffer/glBufferHeap.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glBufferHeap;
+using mini::MemoryRegistry;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static GLsizeiptr align_up(const GLsizeiptr /*value*/, const GLsizeiptr /*alignment*/) noexcept;
+static int lowest_bit(const uint64_t /*mask*/) noexcept;
+static int highest_bit(const uint64_t /*mask*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Destructor
+//////////////////////////////////////////////////////////////////////
+
+glBufferHeap::~glBufferHeap() {
+    m_retired.flush();
+    if (m_bufferID != 0U) {
+        glDeleteBuffers(1, &m_bufferID);
+        MemoryRegistry::Free(MemoryRegistry::Category::BufferHeap, m_capacity);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Constructor
+//////////////////////////////////////////////////////////////////////
+
+glBufferHeap::glBufferHeap(const GLsizeiptr& capacity, const GLbitfield& storageFlags)
+    : m_capacity(align_up(std::max<GLsizeiptr>(capacity, Granularity), Granularity)),
+      m_storageFlags(storageFlags) {
+    std::fill_n(&m_freeHeads[0][0], FirstLevelCount * SecondLevelCount, Null);
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, m_capacity, nullptr, m_storageFlags);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::BufferHeap, m_capacity);
+
+    // Start with a single free block spanning the whole heap
+    m_firstBlock = createNode();
+    m_blocks[m_firstBlock].size = m_capacity;
+    m_blocks[m_firstBlock].free = true;
+    insertFree(m_firstBlock);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+glBufferHeap& glBufferHeap::operator=(glBufferHeap&& other) noexcept {
+    if (&other != this) {
+        m_retired = std::move(other.m_retired);
+        if (m_bufferID != 0U) {
+            glDeleteBuffers(1, &m_bufferID);
+            MemoryRegistry::Free(MemoryRegistry::Category::BufferHeap, m_capacity);
+        }
+        m_blocks = std::move(other.m_blocks);
+        m_unusedNodes = std::move(other.m_unusedNodes);
+        std::copy_n(&other.m_freeHeads[0][0], FirstLevelCount * SecondLevelCount, &m_freeHeads[0][0]);
+        std::copy_n(other.m_secondLevelBitmap, FirstLevelCount, m_secondLevelBitmap);
+        m_firstLevelBitmap = other.m_firstLevelBitmap;
+        m_firstBlock = other.m_firstBlock;
+        m_capacity = other.m_capacity;
+        m_usedBytes = other.m_usedBytes;
+        m_allocationCount = other.m_allocationCount;
+        m_storageFlags = other.m_storageFlags;
+        m_bufferID = other.m_bufferID;
+        other.m_blocks.clear();
+        other.m_unusedNodes.clear();
+        std::fill_n(&other.m_freeHeads[0][0], FirstLevelCount * SecondLevelCount, Null);
+        std::fill_n(other.m_secondLevelBitmap, FirstLevelCount, 0U);
+        other.m_firstLevelBitmap = 0ULL;
+        other.m_firstBlock = Null;
+        other.m_capacity = 0;
+        other.m_usedBytes = 0;
+        other.m_allocationCount = 0;
+        other.m_bufferID = 0;
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// allocate
+//////////////////////////////////////////////////////////////////////
+
+glBufferHeap::Allocation glBufferHeap::allocate(const GLsizeiptr size, const GLsizeiptr alignment) {
+    if (size <= 0 || m_bufferID == 0U)
+        return Allocation{};
+
+    // Over-aligned requests search for enough slack to align within the block
+    const auto blockAlignment = align_up(std::max(alignment, Granularity), Granularity);
+    const auto blockSize = align_up(size, Granularity);
+    auto index = findFree(blockSize + (blockAlignment - Granularity));
+    if (index == Null)
+        return Allocation{};
+    removeFree(index);
+
+    // Return any leading padding to the heap
+    if (const auto padding = align_up(m_blocks[index].offset, blockAlignment) - m_blocks[index].offset;
+        padding > 0) {
+        const auto front = index;
+        index = split(front, padding);
+        m_blocks[front].free = true;
+        insertFree(front);
+    }
+
+    // Return any trailing remainder to the heap
+    if (m_blocks[index].size > blockSize) {
+        const auto tail = split(index, blockSize);
+        m_blocks[tail].free = true;
+        insertFree(tail);
+    }
+
+    auto& block = m_blocks[index];
+    block.free = false;
+    block.requested = size;
+    block.alignment = blockAlignment;
+    m_usedBytes += block.size;
+    ++m_allocationCount;
+    return Allocation{ block.offset, size, index };
+}
+
+//////////////////////////////////////////////////////////////////////
+/// deallocate
+//////////////////////////////////////////////////////////////////////
+
+bool glBufferHeap::deallocate(const Allocation& allocation) noexcept {
+    if (!allocation.valid() || allocation.handle >= m_blocks.size())
+        return false;
+
+    // The offset may predate a defragmentation, only the handle identifies the block
+    auto index = allocation.handle;
+    if (const auto& block = m_blocks[index]; !block.live || block.free)
+        return false;
+
+    m_usedBytes -= m_blocks[index].size;
+    --m_allocationCount;
+    m_blocks[index].free = true;
+
+    // Merge with free neighbours, so no two free blocks are ever adjacent
+    if (const auto next = m_blocks[index].nextPhysical; next != Null && m_blocks[next].free) {
+        removeFree(next);
+        absorbNext(index);
+    }
+    if (const auto prev = m_blocks[index].prevPhysical; prev != Null && m_blocks[prev].free) {
+        removeFree(prev);
+        absorbNext(prev);
+        index = prev;
+    }
+    insertFree(index);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// defragment
+//////////////////////////////////////////////////////////////////////
+
+std::vector<glBufferHeap::Relocation> glBufferHeap::defragment() {
+    std::vector<Relocation> relocations;
+    m_retired.collect();
+    if (m_bufferID == 0U || m_allocationCount == 0U)
+        return relocations;
+
+    // Gather the live blocks in address order, recycling every free node
+    std::vector<uint32_t> live;
+    live.reserve(m_allocationCount);
+    for (auto index = m_firstBlock; index != Null;) {
+        const auto next = m_blocks[index].nextPhysical;
+        if (m_blocks[index].free)
+            releaseNode(index);
+        else
+            live.push_back(index);
+        index = next;
+    }
+    std::fill_n(&m_freeHeads[0][0], FirstLevelCount * SecondLevelCount, Null);
+    std::fill_n(m_secondLevelBitmap, FirstLevelCount, 0U);
+    m_firstLevelBitmap = 0ULL;
+
+    GLuint newBufferID = 0;
+    glCreateBuffers(1, &newBufferID);
+    glNamedBufferStorage(newBufferID, m_capacity, nullptr, m_storageFlags);
+
+    // Pack the blocks to the front, coalescing copies that move by the same amount
+    GLintptr runSource = 0;
+    GLintptr runDestination = 0;
+    GLsizeiptr runSize = 0;
+    GLsizeiptr copiedBytes = 0;
+    GLintptr cursor = 0;
+    uint32_t previous = Null;
+    const auto link = [&](const uint32_t index) {
+        m_blocks[index].prevPhysical = previous;
+        m_blocks[index].nextPhysical = Null;
+        if (previous == Null)
+            m_firstBlock = index;
+        else
+            m_blocks[previous].nextPhysical = index;
+        previous = index;
+    };
+    const auto append_free = [&](const GLintptr offset, const GLsizeiptr size) {
+        const auto index = createNode();
+        m_blocks[index].offset = offset;
+        m_blocks[index].size = size;
+        m_blocks[index].free = true;
+        link(index);
+        insertFree(index);
+    };
+    for (const auto index : live) {
+        const auto source = m_blocks[index].offset;
+        const auto size = m_blocks[index].size;
+        const auto destination = align_up(cursor, m_blocks[index].alignment);
+        if (destination > cursor)
+            append_free(cursor, destination - cursor);
+
+        if (runSize > 0 && source == runSource + runSize && destination == runDestination + runSize) {
+            runSize += size;
+        } else {
+            if (runSize > 0)
+                glCopyNamedBufferSubData(m_bufferID, newBufferID, runSource, runDestination, runSize);
+            runSource = source;
+            runDestination = destination;
+            runSize = size;
+        }
+        if (destination != source)
+            relocations.push_back(Relocation{ index, source, destination, m_blocks[index].requested });
+
+        m_blocks[index].offset = destination;
+        link(index);
+        cursor = destination + size;
+        copiedBytes += size;
+    }
+    if (runSize > 0)
+        glCopyNamedBufferSubData(m_bufferID, newBufferID, runSource, runDestination, runSize);
+    if (cursor < m_capacity)
+        append_free(cursor, m_capacity - cursor);
+
+    // The old storage may still be in use by earlier draws
+    m_retired.retire(m_bufferID, 0, MemoryRegistry::Category::BufferHeap, m_capacity);
+    m_bufferID = newBufferID;
+    MemoryRegistry::Reallocate(MemoryRegistry::Category::BufferHeap, m_capacity, copiedBytes);
+    return relocations;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// statistics
+//////////////////////////////////////////////////////////////////////
+
+glBufferHeap::Statistics glBufferHeap::statistics() const noexcept {
+    Statistics stats;
+    stats.capacity = m_capacity;
+    stats.usedBytes = m_usedBytes;
+    stats.freeBytes = m_capacity - m_usedBytes;
+    stats.allocationCount = m_allocationCount;
+    for (auto index = m_firstBlock; index != Null; index = m_blocks[index].nextPhysical) {
+        if (!m_blocks[index].free)
+            continue;
+        stats.largestFreeBlock = std::max(stats.largestFreeBlock, m_blocks[index].size);
+        ++stats.freeBlockCount;
+    }
+    if (stats.freeBytes > 0)
+        stats.fragmentation =
+            1.0F - (static_cast<float>(stats.largestFreeBlock) / static_cast<float>(stats.freeBytes));
+    return stats;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// MappingInsert
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::MappingInsert(const GLsizeiptr size, int& fl, int& sl) noexcept {
+    // Small blocks get one exact list each, larger ones split each power of two linearly
+    const auto units = static_cast<uint64_t>(size / Granularity);
+    if (units < static_cast<uint64_t>(SecondLevelCount)) {
+        fl = 0;
+        sl = static_cast<int>(units);
+        return;
+    }
+    const auto log2 = highest_bit(units);
+    sl = static_cast<int>((units >> (log2 - SecondLevelLog2)) ^ static_cast<uint64_t>(SecondLevelCount));
+    fl = log2 - SecondLevelLog2 + 1;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// MappingSearch
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::MappingSearch(const GLsizeiptr size, int& fl, int& sl) noexcept {
+    // Round up to the next list boundary, so any block found is large enough
+    auto rounded = size;
+    if (const auto units = static_cast<uint64_t>(size / Granularity); units >= static_cast<uint64_t>(SecondLevelCount))
+        rounded += ((GLsizeiptr(1) << (highest_bit(units) - SecondLevelLog2)) - 1) * Granularity;
+    MappingInsert(rounded, fl, sl);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// findFree
+//////////////////////////////////////////////////////////////////////
+
+uint32_t glBufferHeap::findFree(const GLsizeiptr size) const noexcept {
+    int fl = 0;
+    int sl = 0;
+    MappingSearch(size, fl, sl);
+    if (fl >= FirstLevelCount)
+        return Null;
+
+    // Look for a list in this size class, otherwise take the next non-empty class
+    auto secondLevelMap = m_secondLevelBitmap[fl] & (~0U << sl);
+    if (secondLevelMap == 0U) {
+        const auto firstLevelMap = m_firstLevelBitmap & (~0ULL << (fl + 1));
+        if (firstLevelMap == 0ULL)
+            return Null;
+        fl = lowest_bit(firstLevelMap);
+        secondLevelMap = m_secondLevelBitmap[fl];
+    }
+    return m_freeHeads[fl][lowest_bit(secondLevelMap)];
+}
+
+//////////////////////////////////////////////////////////////////////
+/// insertFree
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::insertFree(const uint32_t index) noexcept {
+    int fl = 0;
+    int sl = 0;
+    MappingInsert(m_blocks[index].size, fl, sl);
+    auto& head = m_freeHeads[fl][sl];
+    m_blocks[index].prevFree = Null;
+    m_blocks[index].nextFree = head;
+    if (head != Null)
+        m_blocks[head].prevFree = index;
+    head = index;
+    m_firstLevelBitmap |= 1ULL << fl;
+    m_secondLevelBitmap[fl] |= 1U << sl;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// removeFree
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::removeFree(const uint32_t index) noexcept {
+    int fl = 0;
+    int sl = 0;
+    MappingInsert(m_blocks[index].size, fl, sl);
+    auto& block = m_blocks[index];
+    if (block.prevFree != Null)
+        m_blocks[block.prevFree].nextFree = block.nextFree;
+    if (block.nextFree != Null)
+        m_blocks[block.nextFree].prevFree = block.prevFree;
+    if (m_freeHeads[fl][sl] == index) {
+        m_freeHeads[fl][sl] = block.nextFree;
+        if (block.nextFree == Null) {
+            m_secondLevelBitmap[fl] &= ~(1U << sl);
+            if (m_secondLevelBitmap[fl] == 0U)
+                m_firstLevelBitmap &= ~(1ULL << fl);
+        }
+    }
+    block.prevFree = Null;
+    block.nextFree = Null;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// split
+//////////////////////////////////////////////////////////////////////
+
+uint32_t glBufferHeap::split(const uint32_t index, const GLsizeiptr size) {
+    // Creating a node may reallocate the node storage, so index rather than reference
+    const auto tail = createNode();
+    m_blocks[tail].offset = m_blocks[index].offset + size;
+    m_blocks[tail].size = m_blocks[index].size - size;
+    m_blocks[tail].prevPhysical = index;
+    m_blocks[tail].nextPhysical = m_blocks[index].nextPhysical;
+    if (m_blocks[tail].nextPhysical != Null)
+        m_blocks[m_blocks[tail].nextPhysical].prevPhysical = tail;
+    m_blocks[index].nextPhysical = tail;
+    m_blocks[index].size = size;
+    return tail;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// absorbNext
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::absorbNext(const uint32_t index) noexcept {
+    const auto next = m_blocks[index].nextPhysical;
+    m_blocks[index].size += m_blocks[next].size;
+    m_blocks[index].nextPhysical = m_blocks[next].nextPhysical;
+    if (m_blocks[index].nextPhysical != Null)
+        m_blocks[m_blocks[index].nextPhysical].prevPhysical = index;
+    releaseNode(next);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// createNode
+//////////////////////////////////////////////////////////////////////
+
+uint32_t glBufferHeap::createNode() {
+    uint32_t index = Null;
+    if (!m_unusedNodes.empty()) {
+        index = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.emplace_back();
+    }
+    m_blocks[index] = Block{};
+    m_blocks[index].live = true;
+    return index;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// releaseNode
+//////////////////////////////////////////////////////////////////////
+
+void glBufferHeap::releaseNode(const uint32_t index) noexcept {
+    m_blocks[index] = Block{};
+    m_unusedNodes.push_back(index);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// align_up
+//////////////////////////////////////////////////////////////////////
+
+static GLsizeiptr align_up(const GLsizeiptr value, const GLsizeiptr alignment) noexcept {
+    return alignment <= 1 ? value : ((value + alignment - 1) / alignment) * alignment;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// lowest_bit
+//////////////////////////////////////////////////////////////////////
+
+static int lowest_bit(const uint64_t mask) noexcept {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+/// highest_bit
+//////////////////////////////////////////////////////////////////////
+
+static int highest_bit(const uint64_t mask) noexcept {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(mask);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+#ifndef MINIGFX_GLBUFFERHEAP_HPP
+#define MINIGFX_GLBUFFERHEAP_HPP
+
+#include "Buffer/glRetirementQueue.hpp"
+#include <cstdint>
+#include <glad/glad.h>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glBufferHeap
+/// \brief  Sub-allocates aligned blocks of a single immutable OpenGL buffer,
+///         using a two-level segregated fit (TLSF) allocator.
+/// \note   Allocation and deallocation are O(1).
+class glBufferHeap {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Identifies a block handed out by the heap.
+    struct Allocation {
+        GLintptr offset = 0;           ///< Byte offset of the block within the heap's buffer.
+        GLsizeiptr size = 0;           ///< Byte size requested for the block.
+        uint32_t handle = UINT32_MAX;  ///< Stable identifier of the block, survives defragmentation.
+
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Check whether this allocation succeeded.
+        /// \return true if this refers to a block, false otherwise.
+        bool valid() const noexcept { return handle != UINT32_MAX; }
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Describes a block moved by defragmentation.
+    struct Relocation {
+        uint32_t handle = UINT32_MAX; ///< The moved block's handle.
+        GLintptr oldOffset = 0;       ///< Where the block used to live.
+        GLintptr newOffset = 0;       ///< Where the block lives now.
+        GLsizeiptr size = 0;          ///< Byte size of the block.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A summary of the heap's usage and fragmentation.
+    struct Statistics {
+        GLsizeiptr capacity = 0;         ///< Total byte-capacity of the heap.
+        GLsizeiptr usedBytes = 0;        ///< Bytes held by live blocks, including alignment padding.
+        GLsizeiptr freeBytes = 0;        ///< Bytes not held by any live block.
+        GLsizeiptr largestFreeBlock = 0; ///< Size of the largest contiguous free block.
+        size_t allocationCount = 0;      ///< Number of live blocks.
+        size_t freeBlockCount = 0;       ///< Number of free blocks.
+        float fragmentation = 0.0F;      ///< 0 when all free space is contiguous, approaching 1 as it scatters.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this heap and its buffer.
+    ~glBufferHeap();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a heap of a fixed size.
+    /// \param  capacity        the byte-capacity of the heap.
+    /// \param  storageFlags    the storage flags of the underlying buffer.
+    explicit glBufferHeap(const GLsizeiptr& capacity, const GLbitfield& storageFlags = GL_DYNAMIC_STORAGE_BIT);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another heap to move from.
+    glBufferHeap(glBufferHeap&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another heap into this one.
+    /// \param  other   another heap to move the data from, to here.
+    glBufferHeap& operator=(glBufferHeap&& other) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Allocate an aligned block from the heap.
+    /// \param  size        the number of bytes needed.
+    /// \param  alignment   the byte alignment of the block, a power of two.
+    /// \return the allocated block, invalid if the heap has no room.
+    Allocation allocate(const GLsizeiptr size, const GLsizeiptr alignment = Granularity);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Return a block to the heap, merging it with free neighbours.
+    /// \note   Blocks are found by handle, so an allocation from before defragment() frees the moved block.
+    /// \param  allocation  the block to free.
+    /// \return true if the block was freed, false if the handle doesn't refer to an allocated block.
+    bool deallocate(const Allocation& allocation) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write the supplied data into a block.
+    /// \param  allocation  the block to write into.
+    /// \param  offset      byte offset from the beginning of the block.
+    /// \param  size        the size of the data to write.
+    /// \param  data        the data to write.
+    void write(const Allocation& allocation, const GLsizeiptr offset, const GLsizeiptr size, const void* data) const
+        noexcept {
+        glNamedBufferSubData(m_bufferID, allocation.offset + offset, size, data);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Pack every live block to the front of fresh storage.
+    /// \note   Copies on the GPU, the old storage is retired until the GPU is done. Replaces the buffer, so
+    ///         bufferID() changes, re-attach it wherever the old ID was cached, e.g. in vertex arrays or bindings.
+    /// \return a remap table of every block that moved.
+    std::vector<Relocation> defragment();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compute usage and fragmentation statistics.
+    /// \return the heap's statistics.
+    Statistics statistics() const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the current byte offset of a block.
+    /// \param  handle      the block's handle.
+    /// \return the block's offset within the heap's buffer, -1 if the handle doesn't refer to an allocated block.
+    GLintptr offsetOf(const uint32_t handle) const noexcept {
+        if (handle >= m_blocks.size() || !m_blocks[handle].live || m_blocks[handle].free)
+            return -1;
+        return m_blocks[handle].offset;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind this heap's buffer to the target specified.
+    /// \param  target      the target type of this buffer.
+    void bindBuffer(const GLenum target) const noexcept { glBindBuffer(target, m_bufferID); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind a block to a particular shader binding point.
+    /// \param  target      the target type of this buffer.
+    /// \param  index       the binding point index to use.
+    /// \param  allocation  the block to bind.
+    void bindBufferRange(const GLenum target, const GLuint index, const Allocation& allocation) const noexcept {
+        glBindBufferRange(target, index, m_bufferID, allocation.offset, allocation.size);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the OpenGL object ID of this heap's buffer.
+    /// \return the buffer ID.
+    GLuint bufferID() const noexcept { return m_bufferID; }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Public Attributes
+    constexpr static GLsizeiptr Granularity = 16; ///< Every block's size and offset is a multiple of this.
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glBufferHeap(const glBufferHeap&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glBufferHeap& operator=(const glBufferHeap&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Constants
+    constexpr static uint32_t Null = UINT32_MAX;    ///< Marks the absence of a block.
+    constexpr static int SecondLevelLog2 = 4;       ///< Log2 of the number of second-level lists.
+    constexpr static int SecondLevelCount = 1 << SecondLevelLog2; ///< Second-level lists per first level.
+    constexpr static int FirstLevelCount = 48;      ///< Number of first-level size classes.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A physical span of the heap, either free or in use.
+    struct Block {
+        GLintptr offset = 0;       ///< Byte offset of the span.
+        GLsizeiptr size = 0;       ///< Byte size of the span.
+        GLsizeiptr requested = 0;  ///< Byte size the owner asked for.
+        GLsizeiptr alignment = 0;  ///< Byte alignment the owner asked for.
+        uint32_t prevPhysical = Null; ///< The span immediately before this one.
+        uint32_t nextPhysical = Null; ///< The span immediately after this one.
+        uint32_t prevFree = Null;  ///< Previous span in the same free list.
+        uint32_t nextFree = Null;  ///< Next span in the same free list.
+        bool free = false;         ///< Whether this span is free.
+        bool live = false;         ///< Whether this node describes a span at all.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Find the free list a block of the supplied size belongs in.
+    /// \param  size        the block size.
+    /// \param  fl          output first-level index.
+    /// \param  sl          output second-level index.
+    static void MappingInsert(const GLsizeiptr size, int& fl, int& sl) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Find the first free list guaranteed to fit the supplied size.
+    /// \param  size        the requested size.
+    /// \param  fl          output first-level index.
+    /// \param  sl          output second-level index.
+    static void MappingSearch(const GLsizeiptr size, int& fl, int& sl) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Find a free block of at least the supplied size.
+    /// \param  size        the required size.
+    /// \return the block index, or Null if none fits.
+    uint32_t findFree(const GLsizeiptr size) const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add a free block to its free list.
+    /// \param  index       the block index.
+    void insertFree(const uint32_t index) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a free block from its free list.
+    /// \param  index       the block index.
+    void removeFree(const uint32_t index) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Split the tail off a block, returning the new tail block.
+    /// \param  index       the block index.
+    /// \param  size        the size to keep in the original block.
+    /// \return the new block's index.
+    uint32_t split(const uint32_t index, const GLsizeiptr size);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Absorb the block after this one into it.
+    /// \param  index       the block index.
+    void absorbNext(const uint32_t index) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve an unused block node.
+    /// \return the node index.
+    uint32_t createNode();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Return a block node to the unused pool.
+    /// \param  index       the node index.
+    void releaseNode(const uint32_t index) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<Block> m_blocks;                                ///< Block nodes, indexed by handle.
+    std::vector<uint32_t> m_unusedNodes;                        ///< Node indices available for reuse.
+    uint32_t m_freeHeads[FirstLevelCount][SecondLevelCount]{};  ///< Heads of each segregated free list.
+    uint64_t m_firstLevelBitmap = 0ULL;                         ///< Non-empty first-level classes.
+    uint32_t m_secondLevelBitmap[FirstLevelCount]{};            ///< Non-empty second-level lists.
+    uint32_t m_firstBlock = Null;                               ///< The block at offset zero.
+    GLsizeiptr m_capacity = 0;                                  ///< Byte-capacity of the heap.
+    GLsizeiptr m_usedBytes = 0;                                 ///< Bytes held by live blocks.
+    size_t m_allocationCount = 0;                               ///< Number of live blocks.
+    GLbitfield m_storageFlags = GL_DYNAMIC_STORAGE_BIT;         ///< OpenGL storage flags.
+    GLuint m_bufferID = 0;                                      ///< OpenGL object ID for the heap.
+    glRetirementQueue m_retired;                                ///< Storage replaced by defragmentation.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLBUFFERHEAP_HPP
\ No newline at end of file
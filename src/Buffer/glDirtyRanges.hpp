@@ -0,0 +1,89 @@
+#pragma once
+#ifndef MINIGFX_GLDIRTYRANGES_HPP
+#define MINIGFX_GLDIRTYRANGES_HPP
+
+#include <algorithm>
+#include <glad/glad.h>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  Map flags for a persistent, non-coherent, explicitly flushed mapping.
+constexpr GLbitfield ExplicitFlushMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Strip the bits from a set of map flags that are invalid storage flags.
+/// \param  mapFlags    the map flags a buffer will be mapped with.
+/// \return the flags safe to pass to glNamedBufferStorage.
+constexpr GLbitfield StorageFlagsFromMapFlags(const GLbitfield mapFlags) noexcept {
+    return mapFlags & ~static_cast<GLbitfield>(GL_MAP_FLUSH_EXPLICIT_BIT);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \class  glDirtyRanges
+/// \brief  Records written byte ranges of an explicitly flushed mapping,
+///         flushing them with as few calls as possible.
+class glDirtyRanges {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Mark a byte range as written.
+    /// \param  offset      byte offset from the beginning.
+    /// \param  size        the size of the range written.
+    void add(const GLintptr offset, const GLsizeiptr size) {
+        if (size <= 0)
+            return;
+
+        // Sequential writes are the common case, extend the last range in place
+        if (!m_ranges.empty()) {
+            auto& last = m_ranges.back();
+            if (offset >= last.offset && offset <= last.end) {
+                last.end = std::max(last.end, offset + size);
+                return;
+            }
+        }
+        m_ranges.push_back(Range{ offset, offset + size });
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Merge every adjacent or overlapping range, then flush them.
+    /// \param  bufferID    the mapped buffer the ranges belong to.
+    void flush(const GLuint bufferID) {
+        if (m_ranges.empty())
+            return;
+
+        std::sort(m_ranges.begin(), m_ranges.end(), [](const Range& a, const Range& b) { return a.offset < b.offset; });
+        auto merged = m_ranges.front();
+        for (size_t x = 1; x < m_ranges.size(); ++x) {
+            if (m_ranges[x].offset <= merged.end) {
+                merged.end = std::max(merged.end, m_ranges[x].end);
+            } else {
+                glFlushMappedNamedBufferRange(bufferID, merged.offset, merged.end - merged.offset);
+                merged = m_ranges[x];
+            }
+        }
+        glFlushMappedNamedBufferRange(bufferID, merged.offset, merged.end - merged.offset);
+        m_ranges.clear();
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Forget every recorded range without flushing.
+    void clear() noexcept { m_ranges.clear(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether any range is awaiting a flush.
+    /// \return true if nothing was written since the last flush.
+    bool empty() const noexcept { return m_ranges.empty(); }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A half-open byte range.
+    struct Range {
+        GLintptr offset = 0; ///< First byte of the range.
+        GLintptr end = 0;    ///< One past the last byte of the range.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<Range> m_ranges; ///< Ranges written since the last flush.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLDIRTYRANGES_HPP
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "Buffer/glDynamicBuffer.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
 #include <cstring>
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
 using mini::glDynamicBuffer;
+using mini::MemoryRegistry;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Destructor
@@ -15,6 +18,8 @@ glDynamicBuffer::~glDynamicBuffer() {
     if (m_bufferID != 0U) {
         glUnmapNamedBuffer(m_bufferID);
         glDeleteBuffers(1, &m_bufferID);
+        MemoryRegistry::Unmap(MemoryRegistry::Category::DynamicBuffer);
+        MemoryRegistry::Free(MemoryRegistry::Category::DynamicBuffer, m_maxCapacity);
     }
 }
 
@@ -25,8 +30,11 @@ glDynamicBuffer::~glDynamicBuffer() {
 glDynamicBuffer::glDynamicBuffer(const GLsizeiptr& capacity, const void* data, const GLbitfield& mapFlags)
     : m_maxCapacity(capacity), m_mapFlags(mapFlags) {
     glCreateBuffers(1, &m_bufferID);
-    glNamedBufferStorage(m_bufferID, m_maxCapacity, data, GL_DYNAMIC_STORAGE_BIT | m_mapFlags);
+    glNamedBufferStorage(
+        m_bufferID, m_maxCapacity, data, GL_DYNAMIC_STORAGE_BIT | StorageFlagsFromMapFlags(m_mapFlags));
     m_bufferPtr = glMapNamedBufferRange(m_bufferID, 0, m_maxCapacity, m_mapFlags);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::DynamicBuffer, m_maxCapacity);
+    MemoryRegistry::Map(MemoryRegistry::Category::DynamicBuffer);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -46,8 +54,14 @@ glDynamicBuffer& glDynamicBuffer::operator=(glDynamicBuffer&& other) noexcept {
         m_bufferPtr = other.m_bufferPtr;
         m_writeFence = other.m_writeFence;
         m_readFence = other.m_readFence;
+        m_fenceSite = other.m_fenceSite;
         m_mapFlags = (other.m_mapFlags);
         m_maxCapacity = (other.m_maxCapacity);
+        m_growthPolicy = other.m_growthPolicy;
+        m_retired = std::move(other.m_retired);
+        m_dirty = std::move(other.m_dirty);
+        m_reservations = std::move(other.m_reservations);
+        m_tracker = std::move(other.m_tracker);
         other.m_bufferID = 0;
         other.m_bufferPtr = nullptr;
         other.m_writeFence = nullptr;
@@ -64,6 +78,7 @@ glDynamicBuffer& glDynamicBuffer::operator=(const glDynamicBuffer& other) noexce
     if (&other != this) {
         m_mapFlags = other.m_mapFlags;
         m_maxCapacity = other.m_maxCapacity;
+        m_growthPolicy = other.m_growthPolicy;
         glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, m_maxCapacity);
     }
     return *this;
@@ -73,9 +88,39 @@ glDynamicBuffer& glDynamicBuffer::operator=(const glDynamicBuffer& other) noexce
 /// write
 //////////////////////////////////////////////////////////////////////
 
-void glDynamicBuffer::write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept {
+void glDynamicBuffer::write(
+    const GLsizeiptr offset, const GLsizeiptr size, const void* data, const glWriteMode mode) noexcept {
     expandToFit(offset, size);
+    if (glWriteTracker::Enabled())
+        m_tracker.record(offset, size, mode);
+
+    switch (mode) {
+    case glWriteMode::InvalidateWhole:
+        orphan();
+        break;
+    case glWriteMode::Synchronized:
+        beginWriting();
+        [[fallthrough]];
+    default:
+        // A persistent mapping can't discard part of its storage, so invalidated ranges are written in place too
+        m_retired.guard(offset);
+        break;
+    }
     std::memcpy(static_cast<unsigned char*>(m_bufferPtr) + offset, data, size);
+    if ((m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U)
+        m_dirty.add(offset, size);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// writeRange
+//////////////////////////////////////////////////////////////////////
+
+void* glDynamicBuffer::writeRange(const GLsizeiptr offset, const GLsizeiptr size) noexcept {
+    expandToFit(offset, size);
+    m_retired.guard(offset);
+    if ((m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U)
+        m_dirty.add(offset, size);
+    return static_cast<unsigned char*>(m_bufferPtr) + offset;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -87,37 +132,118 @@ void glDynamicBuffer::write_immediate(const GLsizeiptr offset, const GLsizeiptr
     glNamedBufferSubData(m_bufferID, offset, size, data);
 }
 
+//////////////////////////////////////////////////////////////////////
+/// beginReservations
+//////////////////////////////////////////////////////////////////////
+
+void glDynamicBuffer::beginReservations(const GLsizeiptr offset) noexcept {
+    m_retired.collect();
+    m_retired.guard(offset);
+    m_reservations.begin(m_bufferPtr, m_maxCapacity, offset);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// commitReservations
+//////////////////////////////////////////////////////////////////////
+
+GLsizeiptr glDynamicBuffer::commitReservations() noexcept {
+    const auto base = m_reservations.base();
+    const auto end = m_reservations.end();
+    const auto explicitFlush = (m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U;
+
+    // Ranges inside the old mapping were written in place, so they must be visible before any growth copies them
+    if (explicitFlush)
+        m_dirty.add(base, std::min(end, m_maxCapacity) - base);
+    expandToFit(0, end);
+
+    // The rest waited in CPU memory for the new storage
+    const auto overflow = m_reservations.overflowBegin();
+    if (overflow < end) {
+        m_retired.guard(overflow);
+        m_reservations.commit(m_bufferPtr);
+        if (explicitFlush)
+            m_dirty.add(overflow, end - overflow);
+    }
+    m_reservations.begin(m_bufferPtr, m_maxCapacity, end);
+    return end;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// endWriting
+//////////////////////////////////////////////////////////////////////
+
+void glDynamicBuffer::endWriting() const noexcept {
+    m_dirty.flush(m_bufferID);
+    glBuffer::endWriting();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// orphan
+//////////////////////////////////////////////////////////////////////
+
+void glDynamicBuffer::orphan() noexcept {
+    GLuint newBuffer = 0;
+    glCreateBuffers(1, &newBuffer);
+    glNamedBufferStorage(
+        newBuffer, m_maxCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT | StorageFlagsFromMapFlags(m_mapFlags));
+
+    // The retirement fence follows every prior use of the old buffer, so the new one starts unfenced
+    m_dirty.flush(m_bufferID);
+    glDeleteSync(m_writeFence);
+    glDeleteSync(m_readFence);
+    m_writeFence = nullptr;
+    m_readFence = nullptr;
+    glUnmapNamedBuffer(m_bufferID);
+    m_retired.retire(m_bufferID, 0, MemoryRegistry::Category::DynamicBuffer, m_maxCapacity);
+
+    m_bufferID = newBuffer;
+    m_bufferPtr = glMapNamedBufferRange(m_bufferID, 0, m_maxCapacity, m_mapFlags);
+    MemoryRegistry::Reallocate(MemoryRegistry::Category::DynamicBuffer, m_maxCapacity, 0);
+    MemoryRegistry::Unmap(MemoryRegistry::Category::DynamicBuffer);
+    MemoryRegistry::Map(MemoryRegistry::Category::DynamicBuffer);
+}
+
 //////////////////////////////////////////////////////////////////////
 /// expandToFit
 //////////////////////////////////////////////////////////////////////
 
 void glDynamicBuffer::expandToFit(const GLsizeiptr offset, const GLsizeiptr size) noexcept {
+    // Release any old storage the GPU has finished with
+    m_retired.collect();
+
     if (offset + size > m_maxCapacity) {
         // Create new buffer large enough to fit old data + new data
         const GLsizeiptr oldSize = m_maxCapacity;
-        m_maxCapacity += offset + (size * 2);
-
-        // Wait for and transfer data from old buffers into new buffers of
-        // the new size
-        WaitForFence(m_writeFence);
-        WaitForFence(m_readFence);
+        m_maxCapacity = m_growthPolicy(m_maxCapacity, offset + size);
 
         // Create new buffer
         GLuint newBuffer = 0;
         glCreateBuffers(1, &newBuffer);
-        glNamedBufferStorage(newBuffer, m_maxCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT | m_mapFlags);
+        glNamedBufferStorage(
+            newBuffer, m_maxCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT | StorageFlagsFromMapFlags(m_mapFlags));
 
-        // Copy old buffer
+        // Copy old buffer, making any unflushed writes visible to the copy first
+        m_dirty.flush(m_bufferID);
         if (oldSize != 0) {
             glCopyNamedBufferSubData(m_bufferID, newBuffer, 0, 0, oldSize);
         }
 
-        // Delete old buffer
+        // The retirement fence follows every prior use of the old buffer
+        glDeleteSync(m_writeFence);
+        glDeleteSync(m_readFence);
+        m_writeFence = nullptr;
+        m_readFence = nullptr;
+
+        // Retire old buffer rather than waiting on it
         glUnmapNamedBuffer(m_bufferID);
-        glDeleteBuffers(1, &m_bufferID);
+        m_retired.retire(m_bufferID, oldSize, MemoryRegistry::Category::DynamicBuffer, oldSize);
+        m_tracker.clear();
 
         // Migrate new buffer
         m_bufferID = newBuffer;
         m_bufferPtr = glMapNamedBufferRange(m_bufferID, 0, m_maxCapacity, m_mapFlags);
+        MemoryRegistry::Reallocate(MemoryRegistry::Category::DynamicBuffer, m_maxCapacity, oldSize);
+        MemoryRegistry::Unmap(MemoryRegistry::Category::DynamicBuffer);
+        MemoryRegistry::Map(MemoryRegistry::Category::DynamicBuffer);
     }
 }
\ No newline at end of file
@@ -3,6 +3,11 @@
 #define MINIGFX_GLDYNAMICBUFFER_HPP
 
 #include "Buffer/glBuffer.hpp"
+#include "Buffer/glDirtyRanges.hpp"
+#include "Buffer/glGrowthPolicy.hpp"
+#include "Buffer/glReservations.hpp"
+#include "Buffer/glRetirementQueue.hpp"
+#include "Buffer/glWriteMode.hpp"
 #include <memory>
 #include <utility>
 
@@ -19,7 +24,7 @@ class glDynamicBuffer final : public glBuffer {
     /// \brief  Construct a new Dynamic buffer.
     /// \param  capacity    the starting capacity of this buffer.
     /// \param  data        optional data buffer, must be at least as large.
-    /// \param  mapFlags    bit-field flags.
+    /// \param  mapFlags    bit-field flags, use ExplicitFlushMapFlags for a non-coherent mapping.
     glDynamicBuffer(
         const GLsizeiptr& capacity = 256, const void* data = nullptr,
         const GLbitfield& mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
@@ -41,6 +46,10 @@ class glDynamicBuffer final : public glBuffer {
     /// \param  other       another buffer to copy the data from, to here.
     glDynamicBuffer& operator=(const glDynamicBuffer& other) noexcept;
 
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Signal that this buffer is finished being written to.
+    /// \note   Flushes the coalesced written ranges of a non-coherent mapping.
+    void endWriting() const noexcept;
     //////////////////////////////////////////////////////////////////////
     /// \brief  Expand this buffer to fit the size provided.
     /// \param  size        the size to expand up to(if not already larger).
@@ -50,7 +59,13 @@ class glDynamicBuffer final : public glBuffer {
     /// \param  offset      byte offset from the beginning.
     /// \param  size        the size of the data to write.
     /// \param  data        the data to write.
-    void write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept;
+    /// \param  mode        how to treat data the GPU may still be reading.
+    /// \note   InvalidateWhole orphans the storage, so never stalls. InvalidateRange writes in place like
+    ///         Unsynchronized, as orphaning would copy the rest of the buffer. Synchronized waits on this
+    ///         buffer's fences, unsynchronized writes straight into the mapping.
+    void write(
+        const GLsizeiptr offset, const GLsizeiptr size, const void* data,
+        const glWriteMode mode = glWriteMode::Unsynchronized) noexcept;
     //////////////////////////////////////////////////////////////////////
     /// \brief  Write the supplied data to GPU memory.
     /// \param  offset      byte offset from the beginning.
@@ -58,19 +73,64 @@ class glDynamicBuffer final : public glBuffer {
     /// \param  data        the data to write.
     void write_immediate(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept;
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Prepare a range of the mapped buffer to be written in place, e.g. through a LayoutView.
+    /// \note   The pointer is invalidated by the next expansion.
+    /// \param  offset      byte offset from the beginning.
+    /// \param  size        the size of the data to be written.
+    /// \return pointer to the start of the range.
+    void* writeRange(const GLsizeiptr offset, const GLsizeiptr size) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Start handing out byte ranges to reserve(), from the offset provided.
+    /// \note   Call from the GL thread, before any worker reserves.
+    /// \param  offset      byte offset the first reservation starts at.
+    void beginReservations(const GLsizeiptr offset = 0) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve a writable byte range, safe to call from any thread at once.
+    /// \note   Never grows the buffer, ranges past its end are written to CPU memory until committed.
+    /// \param  size        the byte-size of the range.
+    /// \param  alignment   the alignment of the range's offset, a power of two.
+    /// \return the reserved range, writable until commitReservations().
+    glReservations::Reservation reserve(const GLsizeiptr size, const GLsizeiptr alignment = 16) {
+        return m_reservations.reserve(size, alignment);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Grow this buffer to fit every reservation, copying in any that overflowed.
+    /// \note   Call from the GL thread, once every worker has finished writing.
+    /// \return the end of the last reservation, in bytes.
+    GLsizeiptr commitReservations() noexcept;
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Expands this buffer's container to fit the desired range.
     /// \note   May invalidate the previous underlying data range.
+    /// \note   Never stalls, the old storage is retired until the GPU is done.
     /// \param  offset      byte offset from the  beginning.
     /// \param  size        the size of the data to write.
     void expandToFit(const GLsizeiptr offset, const GLsizeiptr size) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Set the policy used to pick a new capacity when expanding.
+    /// \param  policy      the growth policy to use.
+    void setGrowthPolicy(const glGrowthPolicy policy) noexcept { m_growthPolicy = policy; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the byte-capacity of this buffer.
+    /// \return the buffer's capacity.
+    GLsizeiptr capacity() const noexcept { return m_maxCapacity; }
 
     private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Replace the storage with new, uninitialized storage of the same capacity, without stalling.
+    /// \note   The old storage is retired until the GPU is done with it.
+    void orphan() noexcept;
+
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
     GLsizeiptr m_maxCapacity = 256; ///< Byte-capacity of this buffer.
     GLbitfield m_mapFlags =
         GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
     void* m_bufferPtr = nullptr;                                        ///< Pointer to underlying buffer data.
+    glGrowthPolicy m_growthPolicy = GeometricGrowth;                    ///< Picks the capacity to expand to.
+    glRetirementQueue m_retired;                                        ///< Storage replaced by expansion.
+    mutable glDirtyRanges m_dirty;                                      ///< Unflushed written ranges.
+    glReservations m_reservations;                                      ///< Ranges handed out to workers.
+    glWriteTracker m_tracker;                                           ///< Detects writes over in-flight ranges.
 };
 }; // namespace mini
 
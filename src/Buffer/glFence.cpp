@@ -0,0 +1,244 @@
+#include "Buffer/glFence.hpp"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glFence;
+using Clock = std::chrono::steady_clock;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static int bucket_of(uint64_t /*ns*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// Site Registry
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+struct SiteRegistry {
+    std::mutex mutex;                                            ///< Guards the sites.
+    std::map<std::string, std::unique_ptr<glFence::Site>> byName; ///< Owning storage, keyed by name.
+};
+
+SiteRegistry& registry() {
+    static SiteRegistry s_registry;
+    return s_registry;
+}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+/// Site::record
+//////////////////////////////////////////////////////////////////////
+
+void glFence::Site::record(const uint64_t stallNs, const bool stalled, const bool timedOut) noexcept {
+    m_waits.fetch_add(1, std::memory_order_relaxed);
+    m_totalNs.fetch_add(stallNs, std::memory_order_relaxed);
+    m_histogram[bucket_of(stallNs)].fetch_add(1, std::memory_order_relaxed);
+    if (stalled)
+        m_stalls.fetch_add(1, std::memory_order_relaxed);
+    if (timedOut)
+        m_timeouts.fetch_add(1, std::memory_order_relaxed);
+
+    // Update the maximum
+    auto currentMax = m_maxNs.load(std::memory_order_relaxed);
+    while (stallNs > currentMax &&
+           !m_maxNs.compare_exchange_weak(currentMax, stallNs, std::memory_order_relaxed)) {
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Site::percentile
+//////////////////////////////////////////////////////////////////////
+
+uint64_t glFence::Site::percentile(const double fraction) const noexcept {
+    uint64_t counts[BucketCount]{};
+    uint64_t total = 0ULL;
+    for (int x = 0; x < BucketCount; ++x) {
+        counts[x] = m_histogram[x].load(std::memory_order_relaxed);
+        total += counts[x];
+    }
+    if (total == 0ULL)
+        return 0ULL;
+
+    // Find the bucket holding the requested rank, interpolating within it
+    const auto rank = std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total);
+    uint64_t cumulative = 0ULL;
+    for (int x = 0; x < BucketCount; ++x) {
+        if (counts[x] == 0ULL)
+            continue;
+        if (static_cast<double>(cumulative + counts[x]) >= rank) {
+            const auto low = x == 0 ? 0.0 : static_cast<double>(1ULL << (x - 1));
+            const auto high = static_cast<double>(x == BucketCount - 1 ? UINT64_MAX : (1ULL << x));
+            const auto within = (rank - static_cast<double>(cumulative)) / static_cast<double>(counts[x]);
+            return static_cast<uint64_t>(low + ((high - low) * within));
+        }
+        cumulative += counts[x];
+    }
+    return m_maxNs.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Site::report
+//////////////////////////////////////////////////////////////////////
+
+glFence::SiteReport glFence::Site::report() const {
+    SiteReport report;
+    report.name = m_name;
+    report.waits = m_waits.load(std::memory_order_relaxed);
+    report.stalls = m_stalls.load(std::memory_order_relaxed);
+    report.timeouts = m_timeouts.load(std::memory_order_relaxed);
+    report.totalStallNs = m_totalNs.load(std::memory_order_relaxed);
+    report.maxStallNs = m_maxNs.load(std::memory_order_relaxed);
+    report.p50StallNs = std::min(percentile(0.5), report.maxStallNs);
+    report.p99StallNs = std::min(percentile(0.99), report.maxStallNs);
+    return report;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Site::reset
+//////////////////////////////////////////////////////////////////////
+
+void glFence::Site::reset() noexcept {
+    m_waits.store(0, std::memory_order_relaxed);
+    m_stalls.store(0, std::memory_order_relaxed);
+    m_timeouts.store(0, std::memory_order_relaxed);
+    m_totalNs.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+    for (auto& bucket : m_histogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Wait
+//////////////////////////////////////////////////////////////////////
+
+bool glFence::Wait(GLsync& fence, Site& site, const WaitPolicy& policy) noexcept {
+    if (fence == nullptr)
+        return true;
+
+    const auto start = Clock::now();
+    const auto elapsed = [&start]() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    };
+
+    // Only the first poll needs to flush, later ones would re-flush needlessly
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (unsigned int attempt = 0U;; ++attempt) {
+        const bool blocking = attempt >= policy.spinCount + policy.yieldCount;
+        const auto waitReturn = glClientWaitSync(fence, waitFlags, blocking ? policy.blockSliceNs : 0U);
+        waitFlags = 0;
+
+        if (waitReturn == GL_ALREADY_SIGNALED || waitReturn == GL_CONDITION_SATISFIED) {
+            glDeleteSync(fence);
+            fence = nullptr;
+            site.record(elapsed(), waitReturn == GL_CONDITION_SATISFIED || attempt > 0U, false);
+            return true;
+        }
+        if (waitReturn == GL_WAIT_FAILED) {
+            // The fence is invalid, waiting any longer would never end
+            glDeleteSync(fence);
+            fence = nullptr;
+            site.record(elapsed(), true, true);
+            return false;
+        }
+        if (policy.timeoutNs != 0U && elapsed() >= policy.timeoutNs) {
+            site.record(elapsed(), true, true);
+            return false;
+        }
+
+        // Back off
+        if (attempt >= policy.spinCount && !blocking)
+            std::this_thread::yield();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Poll
+//////////////////////////////////////////////////////////////////////
+
+bool glFence::Poll(GLsync& fence) noexcept {
+    if (fence == nullptr)
+        return true;
+
+    if (const auto waitReturn = glClientWaitSync(fence, 0, 0);
+        waitReturn == GL_ALREADY_SIGNALED || waitReturn == GL_CONDITION_SATISFIED) {
+        glDeleteSync(fence);
+        fence = nullptr;
+        return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// DefaultPolicy
+//////////////////////////////////////////////////////////////////////
+
+glFence::WaitPolicy& glFence::DefaultPolicy() noexcept {
+    static WaitPolicy s_policy;
+    return s_policy;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// FindSite
+//////////////////////////////////////////////////////////////////////
+
+glFence::Site& glFence::FindSite(const char* name) {
+    auto& sites = registry();
+    std::lock_guard<std::mutex> lock(sites.mutex);
+
+    // Keyed by contents, as names needn't outlive the call, so identical names always share a site
+    auto& site = sites.byName[name];
+    if (!site)
+        site = std::make_unique<Site>(name);
+    return *site;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Report
+//////////////////////////////////////////////////////////////////////
+
+std::vector<glFence::SiteReport> glFence::Report() {
+    std::vector<SiteReport> reports;
+    {
+        auto& sites = registry();
+        std::lock_guard<std::mutex> lock(sites.mutex);
+        reports.reserve(sites.byName.size());
+        for (const auto& [name, site] : sites.byName)
+            reports.push_back(site->report());
+    }
+    std::sort(reports.begin(), reports.end(), [](const SiteReport& a, const SiteReport& b) {
+        return a.totalStallNs > b.totalStallNs;
+    });
+    return reports;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ResetStatistics
+//////////////////////////////////////////////////////////////////////
+
+void glFence::ResetStatistics() {
+    auto& sites = registry();
+    std::lock_guard<std::mutex> lock(sites.mutex);
+    for (auto& [name, site] : sites.byName)
+        site->reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// bucket_of
+//////////////////////////////////////////////////////////////////////
+
+static int bucket_of(uint64_t ns) noexcept {
+    // Bucket x holds waits in [2^(x-1), 2^x)
+    int bucket = 0;
+    while (ns != 0ULL && bucket < 63) {
+        ns >>= 1U;
+        ++bucket;
+    }
+    return bucket;
+}
\ No newline at end of file
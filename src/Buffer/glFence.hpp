@@ -0,0 +1,136 @@
+#pragma once
+#ifndef MINIGFX_GLFENCE_HPP
+#define MINIGFX_GLFENCE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <glad/glad.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glFence
+/// \brief  Waits on OpenGL sync objects, recording stall statistics per call site.
+class glFence {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Controls how a wait backs off while a fence is unsignaled.
+    struct WaitPolicy {
+        unsigned int spinCount = 16;       ///< Number of non-blocking polls before yielding.
+        unsigned int yieldCount = 16;      ///< Number of polls separated by a thread yield, before blocking.
+        GLuint64 blockSliceNs = 1000000U;  ///< Timeout of each blocking wait, in nanoseconds.
+        GLuint64 timeoutNs = 0U;           ///< Total time to wait before giving up, 0 to wait forever.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A read-only copy of one call site's statistics.
+    struct SiteReport {
+        std::string name;             ///< The call site's name.
+        uint64_t waits = 0ULL;        ///< Number of waits on a live fence.
+        uint64_t stalls = 0ULL;       ///< Number of waits where the fence wasn't already signaled.
+        uint64_t timeouts = 0ULL;     ///< Number of waits that gave up before the fence signaled.
+        uint64_t totalStallNs = 0ULL; ///< Total nanoseconds spent waiting.
+        uint64_t maxStallNs = 0ULL;   ///< The longest single wait, in nanoseconds.
+        uint64_t p50StallNs = 0ULL;   ///< Approximate median wait, in nanoseconds.
+        uint64_t p99StallNs = 0ULL;   ///< Approximate 99th percentile wait, in nanoseconds.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \class  Site
+    /// \brief  Lock-free wait counters and a log2 stall histogram for one call site.
+    class Site {
+        public:
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Construct a named call site.
+        /// \param  name    the call site's name.
+        explicit Site(std::string name) : m_name(std::move(name)) {}
+
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Record the outcome of a single wait.
+        /// \param  stallNs     how long the wait took, in nanoseconds.
+        /// \param  stalled     whether the fence was unsignaled at first.
+        /// \param  timedOut    whether the wait gave up.
+        void record(const uint64_t stallNs, const bool stalled, const bool timedOut) noexcept;
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Estimate a percentile of the recorded wait times.
+        /// \param  fraction    the percentile to find, from 0.0 to 1.0.
+        /// \return the estimated wait time in nanoseconds.
+        uint64_t percentile(const double fraction) const noexcept;
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Copy the current statistics out of this site.
+        /// \return a report of this site's statistics.
+        SiteReport report() const;
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Zero every counter in this site.
+        void reset() noexcept;
+
+        private:
+        //////////////////////////////////////////////////////////////////////
+        /// Private Attributes
+        constexpr static int BucketCount = 64;             ///< One bucket per power of two nanoseconds.
+        std::string m_name;                                ///< The call site's name.
+        std::atomic<uint64_t> m_waits{ 0 };                ///< Number of waits.
+        std::atomic<uint64_t> m_stalls{ 0 };               ///< Number of stalled waits.
+        std::atomic<uint64_t> m_timeouts{ 0 };             ///< Number of timed out waits.
+        std::atomic<uint64_t> m_totalNs{ 0 };              ///< Total nanoseconds waited.
+        std::atomic<uint64_t> m_maxNs{ 0 };                ///< Longest wait in nanoseconds.
+        std::atomic<uint64_t> m_histogram[BucketCount]{};  ///< Wait counts bucketed by log2(ns).
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for a fence to signal, then delete it.
+    /// \note   Spins, then yields, then blocks, flushing commands on the first poll.
+    /// \param  fence   the fence to wait on, nulled once it has signaled.
+    /// \param  site    the call site to record statistics against.
+    /// \param  policy  how to back off while waiting.
+    /// \return true if the fence signaled, false if the wait timed out or failed.
+    static bool Wait(GLsync& fence, Site& site, const WaitPolicy& policy = DefaultPolicy()) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for a fence to signal, then delete it.
+    /// \note   Looks the call site up by name on every live fence, frequent waits should pass a cached Site.
+    ///         Throws if the site has to be created and can't be.
+    /// \param  fence   the fence to wait on, nulled once it has signaled.
+    /// \param  name    the name of the call site to record statistics against.
+    /// \param  policy  how to back off while waiting.
+    /// \return true if the fence signaled, false if the wait timed out or failed.
+    static bool Wait(GLsync& fence, const char* name, const WaitPolicy& policy = DefaultPolicy()) {
+        return fence == nullptr ? true : Wait(fence, FindSite(name), policy);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for a fence to signal however long it takes, then delete it.
+    /// \note   For callers about to reuse memory the GPU may be using. Each expired timeout is recorded against the
+    ///         site and the wait carries on, only an invalid fence ends it early.
+    /// \param  fence   the fence to wait on, null once this returns.
+    /// \param  site    the call site to record statistics against.
+    /// \param  policy  how to back off while waiting.
+    static void WaitUntilSignaled(GLsync& fence, Site& site, const WaitPolicy& policy = DefaultPolicy()) noexcept {
+        while (!Wait(fence, site, policy)) {
+        }
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether a fence has signaled without waiting, deleting it if so.
+    /// \param  fence   the fence to poll, nulled once it has signaled.
+    /// \return true if the fence is null or has signaled, false otherwise.
+    static bool Poll(GLsync& fence) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the policy used when none is supplied.
+    /// \note   Should be configured before any other thread is waiting.
+    /// \return reference to the default wait policy.
+    static WaitPolicy& DefaultPolicy() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Find or create the call site with the name provided.
+    /// \note   The name is copied, so needn't be a literal. Locks and may allocate, so cache the result.
+    /// \param  name    the call site's name.
+    /// \return reference to the call site, valid for the life of the program.
+    static Site& FindSite(const char* name);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy the statistics of every call site.
+    /// \return a report per call site, sorted by total stall time, worst first.
+    static std::vector<SiteReport> Report();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Zero the statistics of every call site.
+    static void ResetStatistics();
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLFENCE_HPP
\ No newline at end of file
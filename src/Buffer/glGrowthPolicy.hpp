@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MINIGFX_GLGROWTHPOLICY_HPP
+#define MINIGFX_GLGROWTHPOLICY_HPP
+
+#include <glad/glad.h>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  Computes the new capacity for a container that must grow.
+/// \param  capacity    the container's current capacity.
+/// \param  required    the minimum capacity the container must reach.
+/// \return a capacity at least as large as required.
+using glGrowthPolicy = GLsizeiptr (*)(const GLsizeiptr capacity, const GLsizeiptr required) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Grow by doubling, so that many small appends amortize to O(1).
+/// \param  capacity    the container's current capacity.
+/// \param  required    the minimum capacity the container must reach.
+/// \return the smallest power-of-two multiple of capacity fitting required.
+constexpr GLsizeiptr GeometricGrowth(const GLsizeiptr capacity, const GLsizeiptr required) noexcept {
+    GLsizeiptr newCapacity = capacity > 0 ? capacity : 1;
+    while (newCapacity < required)
+        newCapacity *= 2;
+    return newCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Grow by a factor of 1.5, trading more reallocations for less slack.
+/// \param  capacity    the container's current capacity.
+/// \param  required    the minimum capacity the container must reach.
+/// \return the smallest 1.5x multiple of capacity fitting required.
+constexpr GLsizeiptr HalfGeometricGrowth(const GLsizeiptr capacity, const GLsizeiptr required) noexcept {
+    GLsizeiptr newCapacity = capacity > 1 ? capacity : 2;
+    while (newCapacity < required)
+        newCapacity += newCapacity / 2;
+    return newCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Grow to exactly the size required, never over-allocating.
+/// \param  capacity    the container's current capacity.
+/// \param  required    the minimum capacity the container must reach.
+/// \return the larger of capacity and required.
+constexpr GLsizeiptr ExactGrowth(const GLsizeiptr capacity, const GLsizeiptr required) noexcept {
+    return capacity > required ? capacity : required;
+}
+}; // namespace mini
+
+#endif // MINIGFX_GLGROWTHPOLICY_HPP
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "Buffer/glReadback.hpp"
+#include "Buffer/glFence.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glFence;
+using mini::glReadback;
+using mini::MemoryRegistry;
+
+//////////////////////////////////////////////////////////////////////
+/// Readback Pool
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+constexpr GLsizeiptr MinCapacity = 256;  ///< Smallest pooled buffer, in bytes.
+constexpr int BucketCount = 48;          ///< One bucket per power of two, from MinCapacity up.
+constexpr GLbitfield ReadFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+struct PooledBuffer {
+    GLsync fence = nullptr;      ///< Fence guarding the last copy into this buffer.
+    GLuint bufferID = 0;         ///< The read buffer.
+    void* pointer = nullptr;     ///< Persistent mapping of the read buffer.
+    GLsizeiptr capacity = 0;     ///< Byte-capacity of the read buffer.
+};
+
+std::vector<PooledBuffer>& bucket(const int index) {
+    static std::vector<PooledBuffer> s_buckets[BucketCount];
+    return s_buckets[index];
+}
+
+int bucket_of(const GLsizeiptr capacity) noexcept {
+    int index = 0;
+    while ((MinCapacity << index) < capacity && index < BucketCount - 1)
+        ++index;
+    return index;
+}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+/// Read
+//////////////////////////////////////////////////////////////////////
+
+glReadback glReadback::Read(const GLuint sourceID, const GLintptr offset, const GLsizeiptr size) {
+    glReadback readback;
+    if (sourceID == 0U || size <= 0)
+        return readback;
+
+    // Reuse any pooled buffer of this size class the GPU is done with
+    const auto index = bucket_of(size);
+    auto& pool = bucket(index);
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+        if (glFence::Poll(it->fence)) {
+            readback.m_bufferID = it->bufferID;
+            readback.m_bufferPtr = it->pointer;
+            readback.m_capacity = it->capacity;
+            *it = pool.back();
+            pool.pop_back();
+            break;
+        }
+    }
+    if (readback.m_bufferID == 0U) {
+        readback.m_capacity = std::max(MinCapacity << index, size);
+        glCreateBuffers(1, &readback.m_bufferID);
+        glNamedBufferStorage(readback.m_bufferID, readback.m_capacity, nullptr, ReadFlags);
+        readback.m_bufferPtr = glMapNamedBufferRange(readback.m_bufferID, 0, readback.m_capacity, ReadFlags);
+        MemoryRegistry::Allocate(MemoryRegistry::Category::Readback, readback.m_capacity);
+        MemoryRegistry::Map(MemoryRegistry::Category::Readback);
+    }
+
+    // Make shader writes visible to the copy, then fence it
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glCopyNamedBufferSubData(sourceID, readback.m_bufferID, offset, 0, size);
+    readback.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.m_size = size;
+    return readback;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ReleasePool
+//////////////////////////////////////////////////////////////////////
+
+void glReadback::ReleasePool() noexcept {
+    static auto& s_site = glFence::FindSite("glReadback::ReleasePool");
+    for (int index = 0; index < BucketCount; ++index) {
+        for (auto& pooled : bucket(index)) {
+            glFence::WaitUntilSignaled(pooled.fence, s_site);
+            glUnmapNamedBuffer(pooled.bufferID);
+            glDeleteBuffers(1, &pooled.bufferID);
+            MemoryRegistry::Unmap(MemoryRegistry::Category::Readback);
+            MemoryRegistry::Free(MemoryRegistry::Category::Readback, pooled.capacity);
+        }
+        bucket(index).clear();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ready
+//////////////////////////////////////////////////////////////////////
+
+bool glReadback::ready() noexcept { return m_bufferID != 0U && glFence::Poll(m_fence); }
+
+//////////////////////////////////////////////////////////////////////
+/// wait
+//////////////////////////////////////////////////////////////////////
+
+bool glReadback::wait() noexcept {
+    static auto& s_site = glFence::FindSite("glReadback::wait");
+    return m_bufferID != 0U && glFence::Wait(m_fence, s_site);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// release
+//////////////////////////////////////////////////////////////////////
+
+void glReadback::release() noexcept {
+    if (m_bufferID == 0U)
+        return;
+
+    // An unfinished copy keeps its fence, so the buffer isn't reused until it completes
+    bucket(bucket_of(m_capacity)).push_back(PooledBuffer{ m_fence, m_bufferID, m_bufferPtr, m_capacity });
+    m_fence = nullptr;
+    m_bufferID = 0;
+    m_bufferPtr = nullptr;
+    m_capacity = 0;
+    m_size = 0;
+}
\ No newline at end of file
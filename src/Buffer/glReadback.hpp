@@ -0,0 +1,106 @@
+#pragma once
+#ifndef MINIGFX_GLREADBACK_HPP
+#define MINIGFX_GLREADBACK_HPP
+
+#include <glad/glad.h>
+#include <stddef.h>
+#include <utility>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glReadback
+/// \brief  A pending copy of GPU buffer data into CPU-visible memory.
+/// \note   Backed by pooled, persistently mapped read buffers, returned to the pool on destruction.
+class glReadback {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Return this readback's memory to the pool.
+    ~glReadback() { release(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty readback.
+    glReadback() = default;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another readback to move from.
+    glReadback(glReadback&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another readback into this one.
+    /// \param  other   another readback to move the data from, to here.
+    glReadback& operator=(glReadback&& other) noexcept {
+        if (&other != this) {
+            release();
+            m_fence = other.m_fence;
+            m_bufferID = other.m_bufferID;
+            m_bufferPtr = other.m_bufferPtr;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            other.m_fence = nullptr;
+            other.m_bufferID = 0;
+            other.m_bufferPtr = nullptr;
+            other.m_capacity = 0;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Begin copying a range of a buffer back to the CPU.
+    /// \note   Issues a buffer-update barrier first, so shader writes are captured.
+    /// \param  sourceID    the OpenGL buffer to read from.
+    /// \param  offset      byte offset into the source.
+    /// \param  size        the number of bytes to read.
+    /// \return a handle to the pending readback, empty if size is zero.
+    static glReadback Read(const GLuint sourceID, const GLintptr offset, const GLsizeiptr size);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Delete every pooled read buffer not currently held by a readback.
+    /// \note   Call before destroying the OpenGL context.
+    static void ReleasePool() noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether the data has arrived, without waiting.
+    /// \return true if data() is readable.
+    bool ready() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for the data to arrive.
+    /// \return true if data() is readable.
+    bool wait() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the read data, without copying it.
+    /// \return pointer to the data, or null if it hasn't arrived yet.
+    const void* data() const noexcept { return m_fence == nullptr ? m_bufferPtr : nullptr; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the read data as an array of elements, without copying it.
+    /// \return pointer to the elements, or null if they haven't arrived yet.
+    template <typename T> const T* as() const noexcept { return static_cast<const T*>(data()); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of bytes read.
+    /// \return the byte count.
+    GLsizeiptr size() const noexcept { return m_size; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether this handle refers to a readback.
+    /// \return true if a readback was issued.
+    bool valid() const noexcept { return m_bufferID != 0U; }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glReadback(const glReadback&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glReadback& operator=(const glReadback&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Return this readback's memory to the pool.
+    void release() noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    GLsync m_fence = nullptr;    ///< Fence placed after the copy.
+    GLuint m_bufferID = 0;       ///< The pooled read buffer.
+    void* m_bufferPtr = nullptr; ///< Persistent mapping of the pooled read buffer.
+    GLsizeiptr m_capacity = 0;   ///< Byte-capacity of the pooled read buffer.
+    GLsizeiptr m_size = 0;       ///< Bytes read.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLREADBACK_HPP
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef MINIGFX_GLRESERVATIONS_HPP
+#define MINIGFX_GLRESERVATIONS_HPP
+
+#include <atomic>
+#include <cstring>
+#include <glad/glad.h>
+#include <memory>
+#include <stddef.h>
+#include <utility>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glReservations
+/// \brief  Hands out byte ranges of a mapped buffer to any number of threads at once,
+///         bumping an atomic offset. Ranges past the mapping's end are backed by CPU
+///         memory until the owning thread grows the buffer and commits them.
+/// \note   begin(), overflowBegin() and commit() belong to the GL thread, and must not
+///         overlap with any reserve() call.
+class glReservations {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A writable byte range.
+    struct Reservation {
+        GLsizeiptr offset = 0;   ///< Byte offset of the range within the buffer.
+        void* pointer = nullptr; ///< Where to write the range, valid until the next commit.
+        GLsizeiptr size = 0;     ///< Byte-size of the range.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Discard any uncommitted overflow.
+    ~glReservations() { discard(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Default constructor.
+    glReservations() = default;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another set of reservations to move from.
+    glReservations(glReservations&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, only valid while neither side is being reserved from.
+    /// \param  other   another set of reservations to move the data from, to here.
+    glReservations& operator=(glReservations&& other) noexcept {
+        if (&other != this) {
+            discard();
+            m_mapping = other.m_mapping;
+            m_capacity = other.m_capacity;
+            m_base = other.m_base;
+            m_head.store(other.m_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            m_overflow.store(other.m_overflow.exchange(nullptr), std::memory_order_relaxed);
+            other.m_mapping = nullptr;
+            other.m_capacity = 0;
+            other.m_base = 0;
+            other.m_head.store(0, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Start handing out ranges from an offset of a mapping.
+    /// \param  mapping     pointer to the start of the mapped buffer.
+    /// \param  capacity    byte-size of the mapping.
+    /// \param  offset      byte offset the first range starts at.
+    void begin(void* mapping, const GLsizeiptr capacity, const GLsizeiptr offset) noexcept {
+        discard();
+        m_mapping = static_cast<unsigned char*>(mapping);
+        m_capacity = capacity;
+        m_base = offset;
+        m_head.store(offset, std::memory_order_relaxed);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve a byte range, safe to call from any thread.
+    /// \param  size        the byte-size of the range.
+    /// \param  alignment   the alignment of the range's offset, a power of two.
+    /// \return the reserved range.
+    Reservation reserve(const GLsizeiptr size, const GLsizeiptr alignment) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        GLsizeiptr offset = 0;
+        do {
+            offset = (head + alignment - 1) & ~(alignment - 1);
+        } while (!m_head.compare_exchange_weak(head, offset + size, std::memory_order_relaxed));
+
+        if (offset + size <= m_capacity)
+            return Reservation{ offset, m_mapping + offset, size };
+
+        // Past the end of the mapping, write into CPU memory until the buffer grows
+        auto* node = new Overflow{ offset, size, std::make_unique<unsigned char[]>(static_cast<size_t>(size)) };
+        node->next = m_overflow.load(std::memory_order_relaxed);
+        while (!m_overflow.compare_exchange_weak(
+            node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return Reservation{ offset, node->data.get(), size };
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the offset the first range was reserved from.
+    /// \return the starting byte offset.
+    GLsizeiptr base() const noexcept { return m_base; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the end of the last range reserved.
+    /// \return the byte-size the buffer must have to hold every range.
+    GLsizeiptr end() const noexcept { return m_head.load(std::memory_order_acquire); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the lowest offset written into CPU memory.
+    /// \return the offset of the first overflowing range, or end() if none overflowed.
+    GLsizeiptr overflowBegin() const noexcept {
+        auto lowest = end();
+        for (auto* node = m_overflow.load(std::memory_order_acquire); node; node = node->next)
+            lowest = node->offset < lowest ? node->offset : lowest;
+        return lowest;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy every overflowing range into a mapping large enough to hold them.
+    /// \param  mapping     pointer to the start of the grown, mapped buffer.
+    void commit(void* mapping) noexcept {
+        auto* node = m_overflow.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            std::memcpy(static_cast<unsigned char*>(mapping) + node->offset, node->data.get(), node->size);
+            delete std::exchange(node, node->next);
+        }
+    }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glReservations(const glReservations&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glReservations& operator=(const glReservations&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A range reserved past the end of the mapping.
+    struct Overflow {
+        GLsizeiptr offset = 0;                 ///< Byte offset of the range within the buffer.
+        GLsizeiptr size = 0;                   ///< Byte-size of the range.
+        std::unique_ptr<unsigned char[]> data; ///< CPU memory written in place of the buffer.
+        Overflow* next = nullptr;              ///< The previously reserved overflow.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Delete every overflowing range without copying it.
+    void discard() noexcept {
+        auto* node = m_overflow.exchange(nullptr, std::memory_order_acquire);
+        while (node)
+            delete std::exchange(node, node->next);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    unsigned char* m_mapping = nullptr;           ///< The mapping ranges are handed out from.
+    GLsizeiptr m_capacity = 0;                    ///< Byte-size of the mapping.
+    GLsizeiptr m_base = 0;                        ///< Offset the first range was reserved from.
+    std::atomic<GLsizeiptr> m_head{ 0 };          ///< End of the last range reserved.
+    std::atomic<Overflow*> m_overflow{ nullptr }; ///< Ranges past the mapping, newest first.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLRESERVATIONS_HPP
\ No newline at end of file
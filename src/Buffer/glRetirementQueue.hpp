@@ -0,0 +1,138 @@
+#pragma once
+#ifndef MINIGFX_GLRETIREMENTQUEUE_HPP
+#define MINIGFX_GLRETIREMENTQUEUE_HPP
+
+#include "Buffer/glFence.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glRetirementQueue
+/// \brief  Keeps replaced buffer storage alive until the GPU is done with it.
+class glRetirementQueue {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for every retired buffer, then delete them.
+    ~glRetirementQueue() { flush(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Default constructor.
+    glRetirementQueue() = default;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another queue to move from.
+    glRetirementQueue(glRetirementQueue&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another queue into this one.
+    /// \param  other   another queue to move the data from, to here.
+    glRetirementQueue& operator=(glRetirementQueue&& other) noexcept {
+        if (&other != this) {
+            flush();
+            m_entries = std::move(other.m_entries);
+            m_copyExtent = other.m_copyExtent;
+            other.m_entries.clear();
+            other.m_copyExtent = 0;
+        }
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retire a buffer whose contents were just copied into new storage.
+    /// \note   The buffer should already be unmapped. Its bytes stay accounted for until it's deleted.
+    /// \param  bufferID    the old buffer to retire.
+    /// \param  copiedBytes how many leading bytes are being copied into the new storage.
+    /// \param  category    the category the old buffer's storage is accounted against.
+    /// \param  bytes       the size of the old buffer's storage.
+    void retire(
+        const GLuint bufferID, const GLsizeiptr copiedBytes, const MemoryRegistry::Category category,
+        const GLsizeiptr bytes) noexcept {
+        m_entries.push_back(Entry{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), bufferID, category, bytes });
+        m_copyExtent = copiedBytes;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Fence a GPU copy into the live storage, without retiring a buffer.
+    /// \param  copiedBytes how many leading bytes are being copied into the live storage.
+    void fenceCopy(const GLsizeiptr copiedBytes) noexcept {
+        m_entries.push_back(Entry{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+        m_copyExtent = copiedBytes;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Delete any retired buffers the GPU has finished with.
+    /// \note   Never blocks.
+    void collect() noexcept {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (!glFence::Poll(it->fence)) {
+                ++it;
+                continue;
+            }
+            release(*it);
+            it = m_entries.erase(it);
+        }
+        if (m_entries.empty())
+            m_copyExtent = 0;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Make a CPU write at the offset provided safe from pending copies.
+    /// \note   Only blocks if the offset lies within data still being copied.
+    /// \param  offset      byte offset from the beginning of the new storage.
+    void guard(const GLsizeiptr offset) noexcept {
+        if (offset < m_copyExtent && !m_entries.empty()) {
+            static auto& s_site = glFence::FindSite("glRetirementQueue::guard");
+            glFence::WaitUntilSignaled(m_entries.back().fence, s_site);
+            m_copyExtent = 0;
+        }
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for every retired buffer, then delete them.
+    void flush() noexcept {
+        static auto& s_site = glFence::FindSite("glRetirementQueue::flush");
+        for (auto& entry : m_entries) {
+            glFence::WaitUntilSignaled(entry.fence, s_site);
+            release(entry);
+        }
+        m_entries.clear();
+        m_copyExtent = 0;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of buffers awaiting deletion.
+    /// \return the retired buffer count.
+    size_t size() const noexcept { return m_entries.size(); }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glRetirementQueue(const glRetirementQueue&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glRetirementQueue& operator=(const glRetirementQueue&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A buffer kept alive until its fence signals.
+    struct Entry {
+        GLsync fence = nullptr;              ///< Fence placed after the buffer's final use.
+        GLuint bufferID = 0;                 ///< The retired OpenGL buffer object, 0 if only fencing a copy.
+        MemoryRegistry::Category category{}; ///< The category the buffer's storage is accounted against.
+        GLsizeiptr bytes = 0;                ///< Size of the buffer's storage.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Delete a retired buffer, no longer accounting for its storage.
+    /// \param  entry   the entry whose buffer to delete, its fence already signaled.
+    static void release(Entry& entry) noexcept {
+        if (entry.bufferID == 0U)
+            return;
+        glDeleteBuffers(1, &entry.bufferID);
+        MemoryRegistry::Free(entry.category, entry.bytes);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<Entry> m_entries; ///< Retired buffers, oldest first.
+    GLsizeiptr m_copyExtent = 0;  ///< Bytes of the live storage still being copied into.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLRETIREMENTQUEUE_HPP
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Buffer/glRingBuffer.hpp"
+#include "Buffer/glFence.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glFence;
+using mini::glRingBuffer;
+using mini::MemoryRegistry;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static GLsizeiptr align_up(const GLsizeiptr /*value*/, const GLsizeiptr /*alignment*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Destructor
+//////////////////////////////////////////////////////////////////////
+
+glRingBuffer::~glRingBuffer() {
+    static auto& s_site = glFence::FindSite("glRingBuffer::~glRingBuffer");
+    for (auto& region : m_regions)
+        glFence::WaitUntilSignaled(region.fence, s_site);
+    if (m_bufferID != 0U) {
+        glUnmapNamedBuffer(m_bufferID);
+        glDeleteBuffers(1, &m_bufferID);
+        MemoryRegistry::Unmap(MemoryRegistry::Category::RingBuffer);
+        MemoryRegistry::Free(MemoryRegistry::Category::RingBuffer, m_capacity);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Constructor
+//////////////////////////////////////////////////////////////////////
+
+glRingBuffer::glRingBuffer(const GLsizeiptr& capacity, const GLbitfield& mapFlags)
+    : m_capacity(capacity), m_mapFlags(mapFlags) {
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, m_capacity, nullptr, m_mapFlags);
+    m_bufferPtr = glMapNamedBufferRange(m_bufferID, 0, m_capacity, m_mapFlags);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::RingBuffer, m_capacity);
+    MemoryRegistry::Map(MemoryRegistry::Category::RingBuffer);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+glRingBuffer& glRingBuffer::operator=(glRingBuffer&& other) noexcept {
+    if (&other != this) {
+        m_regions = std::move(other.m_regions);
+        m_capacity = other.m_capacity;
+        m_head = other.m_head;
+        m_used = other.m_used;
+        m_pendingBytes = other.m_pendingBytes;
+        m_mapFlags = other.m_mapFlags;
+        m_bufferID = other.m_bufferID;
+        m_bufferPtr = other.m_bufferPtr;
+        other.m_regions.clear();
+        other.m_capacity = 0;
+        other.m_head = 0;
+        other.m_used = 0;
+        other.m_pendingBytes = 0;
+        other.m_mapFlags = 0;
+        other.m_bufferID = 0;
+        other.m_bufferPtr = nullptr;
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// allocate
+//////////////////////////////////////////////////////////////////////
+
+glRingBuffer::Range glRingBuffer::allocate(const GLsizeiptr size, const GLsizeiptr alignment) noexcept {
+    if (size <= 0 || size > m_capacity || m_bufferPtr == nullptr)
+        return Range{};
+
+    // Recycle finished regions, an idle ring starts over from the front rather than skipping its tail
+    reclaim();
+    if (m_used == 0)
+        m_head = 0;
+
+    // Find where the range lands, wrapping to the front if it won't fit
+    GLsizeiptr offset = align_up(m_head, alignment);
+    GLsizeiptr required = (offset - m_head) + size;
+    if (offset + size > m_capacity) {
+        offset = 0;
+        required = (m_capacity - m_head) + size;
+    }
+
+    // Only stall if the GPU is truly behind
+    while (m_used + required > m_capacity) {
+        // Everything left is still being written by the CPU
+        if (m_regions.empty())
+            return Range{};
+
+        static auto& s_site = glFence::FindSite("glRingBuffer::allocate");
+        auto& oldest = m_regions.front();
+        glFence::WaitUntilSignaled(oldest.fence, s_site);
+        m_used -= oldest.size;
+        m_regions.pop_front();
+        if (m_used == 0) {
+            m_head = 0;
+            offset = 0;
+            required = size;
+        }
+    }
+
+    // Claim the range
+    m_head = offset + size;
+    m_used += required;
+    m_pendingBytes += required;
+    return Range{ offset, size, static_cast<unsigned char*>(m_bufferPtr) + offset };
+}
+
+//////////////////////////////////////////////////////////////////////
+/// write
+//////////////////////////////////////////////////////////////////////
+
+glRingBuffer::Range glRingBuffer::write(const GLsizeiptr size, const void* data, const GLsizeiptr alignment) noexcept {
+    const auto range = allocate(size, alignment);
+    if (range.pointer != nullptr)
+        std::memcpy(range.pointer, data, size);
+    return range;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// retire
+//////////////////////////////////////////////////////////////////////
+
+void glRingBuffer::retire() noexcept {
+    if (m_pendingBytes > 0) {
+        m_regions.push_back(Region{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_pendingBytes });
+        m_pendingBytes = 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// reclaim
+//////////////////////////////////////////////////////////////////////
+
+void glRingBuffer::reclaim() noexcept {
+    // Regions retire in order, so stop at the first one still in use
+    while (!m_regions.empty() && glFence::Poll(m_regions.front().fence)) {
+        m_used -= m_regions.front().size;
+        m_regions.pop_front();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// align_up
+//////////////////////////////////////////////////////////////////////
+
+static GLsizeiptr align_up(const GLsizeiptr value, const GLsizeiptr alignment) noexcept {
+    if (alignment <= 1)
+        return value;
+    return ((value + alignment - 1) / alignment) * alignment;
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef MINIGFX_GLRINGBUFFER_HPP
+#define MINIGFX_GLRINGBUFFER_HPP
+
+#include <deque>
+#include <glad/glad.h>
+#include <utility>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glRingBuffer
+/// \brief  A persistently mapped OpenGL buffer that sub-allocates aligned
+///         ranges in a ring, fencing only the regions that were retired.
+class glRingBuffer {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Defines a range of memory handed out by the ring.
+    struct Range {
+        GLintptr offset = 0;     ///< Byte offset into the ring buffer.
+        GLsizeiptr size = 0;     ///< Byte size of the range.
+        void* pointer = nullptr; ///< Mapped pointer to the range, null if allocation failed.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for all fences to complete, then destroy this buffer.
+    ~glRingBuffer();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a new ring buffer.
+    /// \param  capacity    the fixed byte capacity of the ring.
+    /// \param  mapFlags    bit-field flags.
+    explicit glRingBuffer(
+        const GLsizeiptr& capacity = 4194304,
+        const GLbitfield& mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another buffer to move from.
+    glRingBuffer(glRingBuffer&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another buffer into this one.
+    /// \param  other   another buffer to move the data from, to here.
+    glRingBuffer& operator=(glRingBuffer&& other) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve an aligned range of the ring for writing.
+    /// \note   Only stalls if the GPU still holds every retired region needed.
+    /// \param  size        the number of bytes to reserve.
+    /// \param  alignment   the byte alignment of the range's offset.
+    /// \return the reserved range, with a null pointer if it can't fit.
+    Range allocate(const GLsizeiptr size, const GLsizeiptr alignment = 16) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve an aligned range and copy the supplied data into it.
+    /// \param  size        the size of the data to write.
+    /// \param  data        the data to write.
+    /// \param  alignment   the byte alignment of the range's offset.
+    /// \return the range written to, with a null pointer if it can't fit.
+    Range write(const GLsizeiptr size, const void* data, const GLsizeiptr alignment = 16) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Fence every range allocated since the last retirement.
+    /// \note   Call after submitting the GPU commands that read those ranges.
+    void retire() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Recycle any retired regions the GPU has finished with.
+    /// \note   Never blocks.
+    void reclaim() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind this buffer to the target specified.
+    /// \param  target      the target type of this buffer.
+    void bindBuffer(const GLenum target) const noexcept { glBindBuffer(target, m_bufferID); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind a range of this buffer to a particular shader binding point.
+    /// \param  target      the target type of this buffer.
+    /// \param  index       the binding point index to use.
+    /// \param  range       the range of this buffer to bind.
+    void bindBufferRange(const GLenum target, const GLuint index, const Range& range) const noexcept {
+        glBindBufferRange(target, index, m_bufferID, range.offset, range.size);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the OpenGL object ID of this buffer.
+    /// \return the buffer ID.
+    GLuint bufferID() const noexcept { return m_bufferID; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the fixed byte capacity of this ring.
+    /// \return the ring's capacity.
+    GLsizeiptr capacity() const noexcept { return m_capacity; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of bytes not held by the CPU or GPU.
+    /// \return the free byte count.
+    GLsizeiptr available() const noexcept { return m_capacity - m_used; }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glRingBuffer(const glRingBuffer&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glRingBuffer& operator=(const glRingBuffer&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A contiguous, fenced span of the ring the GPU may still read.
+    struct Region {
+        GLsync fence = nullptr; ///< Fence placed when the region was retired.
+        GLsizeiptr size = 0;    ///< Number of bytes covered, including padding.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::deque<Region> m_regions;  ///< Retired regions, oldest first.
+    GLsizeiptr m_capacity = 0;     ///< Byte-capacity of this buffer.
+    GLsizeiptr m_head = 0;         ///< Offset of the next allocation.
+    GLsizeiptr m_used = 0;         ///< Bytes held by retired and pending regions.
+    GLsizeiptr m_pendingBytes = 0; ///< Bytes allocated since the last retirement.
+    GLbitfield m_mapFlags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
+    GLuint m_bufferID = 0;                                              ///< OpenGL object ID for this buffer.
+    void* m_bufferPtr = nullptr;                                        ///< Pointer to underlying buffer data.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLRINGBUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "Buffer/glStagingBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glStagingBuffer;
+
+//////////////////////////////////////////////////////////////////////
+/// stage
+//////////////////////////////////////////////////////////////////////
+
+bool glStagingBuffer::stage(const GLuint destinationID, const GLintptr offset, const GLsizeiptr size, const void* data) {
+    if (size == 0)
+        return true;
+    if (destinationID == 0U || size < 0 || data == nullptr)
+        return false;
+
+    // Large uploads are split so a single one can never exhaust the ring
+    const auto maxChunk = std::max<GLsizeiptr>(m_ring.capacity() / 4, 1);
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (GLsizeiptr done = 0; done < size;) {
+        const auto chunk = std::min(size - done, maxChunk);
+        auto range = m_ring.allocate(chunk, 1);
+        if (range.pointer == nullptr) {
+            // Every remaining byte of the ring is staged but not yet submitted
+            flush();
+            range = m_ring.allocate(chunk, 1);
+            if (range.pointer == nullptr)
+                return false;
+        }
+        std::memcpy(range.pointer, bytes + done, chunk);
+        m_copies.push_back(Copy{ destinationID, range.offset, offset + done, chunk, m_copies.size() });
+        m_pendingBytes += chunk;
+        done += chunk;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// flush
+//////////////////////////////////////////////////////////////////////
+
+void glStagingBuffer::flush() {
+    if (m_copies.empty())
+        return;
+
+    // Group by destination, in destination order, so neighbouring uploads can merge
+    std::sort(m_copies.begin(), m_copies.end(), [](const Copy& a, const Copy& b) {
+        if (a.destinationID != b.destinationID)
+            return a.destinationID < b.destinationID;
+        if (a.destination != b.destination)
+            return a.destination < b.destination;
+        return a.sequence < b.sequence;
+    });
+
+    const auto sourceID = m_ring.bufferID();
+    for (auto groupBegin = m_copies.begin(); groupBegin != m_copies.end();) {
+        const auto groupEnd = std::find_if(groupBegin, m_copies.end(), [&](const Copy& copy) {
+            return copy.destinationID != groupBegin->destinationID;
+        });
+
+        // Overlapping uploads must land in the order they were staged
+        const bool overlapping = std::adjacent_find(groupBegin, groupEnd, [](const Copy& a, const Copy& b) {
+                                     return b.destination < a.destination + a.size;
+                                 }) != groupEnd;
+        if (overlapping)
+            std::sort(groupBegin, groupEnd, [](const Copy& a, const Copy& b) { return a.sequence < b.sequence; });
+
+        // Merge runs that are contiguous in both the ring and the destination
+        auto merged = *groupBegin;
+        for (auto it = std::next(groupBegin); it != groupEnd; ++it) {
+            if (it->source == merged.source + merged.size && it->destination == merged.destination + merged.size) {
+                merged.size += it->size;
+            } else {
+                glCopyNamedBufferSubData(
+                    sourceID, merged.destinationID, merged.source, merged.destination, merged.size);
+                merged = *it;
+            }
+        }
+        glCopyNamedBufferSubData(sourceID, merged.destinationID, merged.source, merged.destination, merged.size);
+        groupBegin = groupEnd;
+    }
+
+    // Fence the copies, recycling the ring space once they complete
+    m_ring.retire();
+    m_copies.clear();
+    m_pendingBytes = 0;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef MINIGFX_GLSTAGINGBUFFER_HPP
+#define MINIGFX_GLSTAGINGBUFFER_HPP
+
+#include "Buffer/glBuffer.hpp"
+#include "Buffer/glRingBuffer.hpp"
+#include <cstdint>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glStagingBuffer
+/// \brief  Batches many small uploads into other buffers through a
+///         persistently mapped ring, submitting them as merged GPU copies.
+class glStagingBuffer {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Submit any staged copies, then destroy this buffer.
+    ~glStagingBuffer() { flush(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a staging buffer.
+    /// \param  capacity    the byte capacity of the upload ring.
+    explicit glStagingBuffer(const GLsizeiptr& capacity = 8388608) : m_ring(capacity) {}
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another staging buffer to move from.
+    glStagingBuffer(glStagingBuffer&& other) noexcept = default;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another staging buffer into this one.
+    /// \param  other   another staging buffer to move the data from, to here.
+    glStagingBuffer& operator=(glStagingBuffer&& other) noexcept {
+        if (&other != this) {
+            flush();
+            m_ring = std::move(other.m_ring);
+            m_copies = std::move(other.m_copies);
+            m_pendingBytes = other.m_pendingBytes;
+            other.m_copies.clear();
+            other.m_pendingBytes = 0;
+        }
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy the supplied data into the ring, to be uploaded on the next flush.
+    /// \note   Flushes early if the ring runs out of room. Large uploads are staged in pieces, so on failure the
+    ///         leading part of the data may already be staged or submitted.
+    /// \param  destinationID   the OpenGL buffer to upload into.
+    /// \param  offset          byte offset into the destination.
+    /// \param  size            the size of the data to upload.
+    /// \param  data            the data to upload.
+    /// \return true if every byte was staged, false if the ring couldn't hold the rest even after flushing.
+    bool stage(const GLuint destinationID, const GLintptr offset, const GLsizeiptr size, const void* data);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy the supplied data into the ring, to be uploaded on the next flush.
+    /// \param  destination     the buffer to upload into.
+    /// \param  offset          byte offset into the destination.
+    /// \param  size            the size of the data to upload.
+    /// \param  data            the data to upload.
+    /// \return true if every byte was staged.
+    bool stage(const glBuffer& destination, const GLintptr offset, const GLsizeiptr size, const void* data) {
+        return stage(destination.bufferID(), offset, size, data);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Submit every staged upload, merging contiguous copies per destination.
+    /// \note   Later stages to overlapping bytes still win.
+    void flush();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of uploads awaiting a flush.
+    /// \return the staged copy count.
+    size_t pendingCopies() const noexcept { return m_copies.size(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of bytes awaiting a flush.
+    /// \return the staged byte count.
+    GLsizeiptr pendingBytes() const noexcept { return m_pendingBytes; }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glStagingBuffer(const glStagingBuffer&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glStagingBuffer& operator=(const glStagingBuffer&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A single recorded upload.
+    struct Copy {
+        GLuint destinationID = 0;  ///< The buffer to upload into.
+        GLintptr source = 0;       ///< Byte offset of the data within the ring.
+        GLintptr destination = 0;  ///< Byte offset within the destination.
+        GLsizeiptr size = 0;       ///< Byte size of the upload.
+        uint64_t sequence = 0ULL;  ///< Order the upload was staged in.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    glRingBuffer m_ring;           ///< Persistently mapped upload memory.
+    std::vector<Copy> m_copies;    ///< Uploads staged since the last flush.
+    GLsizeiptr m_pendingBytes = 0; ///< Bytes staged since the last flush.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLSTAGINGBUFFER_HPP
\ No newline at end of file
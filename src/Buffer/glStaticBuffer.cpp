@@ -1,9 +1,12 @@
 #include "Buffer/glStaticBuffer.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <cstring>
 #include <utility>
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
 using mini::glStaticBuffer;
+using mini::MemoryRegistry;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Destructor
@@ -12,6 +15,7 @@ using mini::glStaticBuffer;
 glStaticBuffer::~glStaticBuffer() {
     if (m_bufferID != 0) {
         glDeleteBuffers(1, &m_bufferID);
+        MemoryRegistry::Free(MemoryRegistry::Category::StaticBuffer, static_cast<GLsizeiptr>(m_size));
     }
 }
 
@@ -23,6 +27,7 @@ glStaticBuffer::glStaticBuffer(const GLsizeiptr& size, const void* data, const G
     : m_size(size), m_storageFlags(storageFlags) {
     glCreateBuffers(1, &m_bufferID);
     glNamedBufferStorage(m_bufferID, size, data, storageFlags);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::StaticBuffer, size);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -42,7 +47,9 @@ glStaticBuffer::glStaticBuffer(glStaticBuffer&& other) noexcept { (*this) = std:
 
 glStaticBuffer& glStaticBuffer::operator=(const glStaticBuffer& other) noexcept {
     if (this != &other) {
-        m_size = other.m_size;
+        // Immutable storage can't be resized, so replace it if the sizes differ
+        if (m_bufferID == 0 || m_size != other.m_size)
+            return (*this) = glStaticBuffer(other);
         m_storageFlags = other.m_storageFlags;
         glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, other.m_size);
     }
@@ -53,9 +60,15 @@ glStaticBuffer& glStaticBuffer::operator=(const glStaticBuffer& other) noexcept
 
 glStaticBuffer& glStaticBuffer::operator=(glStaticBuffer&& other) noexcept {
     if (this != &other) {
+        if (m_bufferID != 0) {
+            glDeleteBuffers(1, &m_bufferID);
+            MemoryRegistry::Free(MemoryRegistry::Category::StaticBuffer, static_cast<GLsizeiptr>(m_size));
+        }
         m_bufferID = other.m_bufferID;
         m_size = other.m_size;
         m_storageFlags = other.m_storageFlags;
+        m_fenceSite = other.m_fenceSite;
+        m_tracker = std::move(other.m_tracker);
         other.m_bufferID = 0;
         other.m_size = 0;
         other.m_storageFlags = 0;
@@ -67,6 +80,33 @@ glStaticBuffer& glStaticBuffer::operator=(glStaticBuffer&& other) noexcept {
 /// write
 //////////////////////////////////////////////////////////////////////
 
-void glStaticBuffer::write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept {
+void glStaticBuffer::write(
+    const GLsizeiptr offset, const GLsizeiptr size, const void* data, const glWriteMode mode) noexcept {
+    if (glWriteTracker::Enabled())
+        m_tracker.record(offset, size, mode);
+
+    switch (mode) {
+    case glWriteMode::InvalidateWhole:
+        glInvalidateBufferData(m_bufferID);
+        break;
+    case glWriteMode::InvalidateRange:
+        glInvalidateBufferSubData(m_bufferID, offset, size);
+        break;
+    case glWriteMode::Unsynchronized:
+        // Mapping without synchronization skips the driver's hazard tracking altogether
+        if ((m_storageFlags & GL_MAP_WRITE_BIT) != 0U) {
+            if (auto* pointer = glMapNamedBufferRange(
+                    m_bufferID, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)) {
+                MemoryRegistry::Map(MemoryRegistry::Category::StaticBuffer);
+                std::memcpy(pointer, data, size);
+                glUnmapNamedBuffer(m_bufferID);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::StaticBuffer);
+                return;
+            }
+        }
+        break;
+    default:
+        break;
+    }
     glNamedBufferSubData(m_bufferID, offset, size, data);
 }
\ No newline at end of file
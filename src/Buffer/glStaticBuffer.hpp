@@ -3,6 +3,7 @@
 #define MINIGFX_GLSTATICBUFFER_HPP
 
 #include "Buffer/glBuffer.hpp"
+#include "Buffer/glWriteMode.hpp"
 #include <stddef.h>
 
 namespace mini {
@@ -46,13 +47,18 @@ class glStaticBuffer final : public glBuffer {
     /// \param  offset      byte offset from the beginning.
     /// \param  size        the size of the data to write.
     /// \param  data        the data to write.
-    void write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept;
+    /// \param  mode        how to treat data the GPU may still be reading.
+    /// \note   Unsynchronized writes need GL_MAP_WRITE_BIT storage, else they fall back to synchronized.
+    void write(
+        const GLsizeiptr offset, const GLsizeiptr size, const void* data,
+        const glWriteMode mode = glWriteMode::Synchronized) noexcept;
 
     private:
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
     size_t m_size = 0ull;                               ///< Byte-size of this buffer.
     GLbitfield m_storageFlags = GL_DYNAMIC_STORAGE_BIT; ///< OpenGL map storage flags.
+    glWriteTracker m_tracker;                           ///< Detects writes over in-flight ranges when enabled.
 };
 }; // namespace mini
 
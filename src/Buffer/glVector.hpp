@@ -3,34 +3,57 @@
 #define MINIGFX_GLVECTOR_HPP
 
 #include "Buffer/glBuffer.hpp"
+#include "Buffer/glDirtyRanges.hpp"
+#include "Buffer/glGrowthPolicy.hpp"
+#include "Buffer/glRetirementQueue.hpp"
+#include "Utility/memoryRegistry.hpp"
 #include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace mini {
 //////////////////////////////////////////////////////////////////////
 /// \class  glVector
 /// \brief  An STL-like vector for OpenGL buffered data.
+/// \note   Elements live directly in persistently mapped GPU memory, growing
+///         geometrically so that steady-state appends never reallocate.
 /// \tparam T   the type of element to construct an array of.
 template <typename T> class glVector final : public glBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "glVector elements are copied by the GPU");
+
     public:
+    //////////////////////////////////////////////////////////////////////
+    /// Public Aliases
+    using value_type = T;              ///< The element type.
+    using iterator = T*;               ///< A random-access iterator over the elements.
+    using const_iterator = const T*;   ///< A random-access iterator over const elements.
+
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy this GL Vector.
     ~glVector() {
         // Safely destroy each buffer this class owns
-        WaitForFence(m_writeFence);
-        WaitForFence(m_readFence);
+        WaitForFence(m_writeFence, fenceSite());
+        WaitForFence(m_readFence, fenceSite());
         if (m_bufferID) {
             glUnmapNamedBuffer(m_bufferID);
             glDeleteBuffers(1, &m_bufferID);
+            MemoryRegistry::Unmap(MemoryRegistry::Category::Vector);
+            MemoryRegistry::Free(MemoryRegistry::Category::Vector, byteSize(m_capacity));
         }
     }
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Construct a GL Vector.
+    /// \brief  Construct an empty GL Vector.
     /// \param  capacity    the starting capacity (1 or more).
-    glVector(const size_t& capacity = 1) : m_capacity(std::max(1ull, capacity)) {
-        const auto bufferSize = sizeof(T) * m_capacity;
-        glCreateBuffers(1, &m_bufferID);
-        glNamedBufferStorage(m_bufferID, bufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT | BufferFlags);
-        m_bufferPtr = static_cast<T*>(glMapNamedBufferRange(m_bufferID, 0, bufferSize, BufferFlags));
+    /// \param  mapFlags    bit-field flags, use ExplicitFlushMapFlags for a non-coherent mapping.
+    explicit glVector(
+        const size_t& capacity = 1,
+        const GLbitfield& mapFlags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+        : m_capacity(std::max<size_t>(1ULL, capacity)), m_mapFlags(mapFlags) {
+        m_fenceSite = &glFence::FindSite("glVector");
+        m_bufferID = createStorage(m_capacity);
+        m_bufferPtr = mapStorage(m_bufferID, m_capacity);
+        MemoryRegistry::Allocate(MemoryRegistry::Category::Vector, byteSize(m_capacity));
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Move constructor.
@@ -39,91 +62,292 @@ template <typename T> class glVector final : public glBuffer {
     //////////////////////////////////////////////////////////////////////
     /// \brief  Copy constructor.
     /// \param  other   another buffer to move the data from, to here.
-    glVector(const glVector& other) noexcept : glVector(other.m_capacity) {
-        glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, m_capacity);
+    glVector(const glVector& other) noexcept : glVector(other.m_capacity, other.m_mapFlags) {
+        m_size = other.m_size;
+        glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, byteSize(m_size));
+        m_retired.fenceCopy(byteSize(m_size));
     }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Movement operator, for moving another buffer into this one.
     /// \param  other   another buffer to move the data from, to here.
     glVector& operator=(glVector&& other) noexcept {
-        m_bufferID = std::move(other.m_bufferID);
-        m_bufferPtr = std::move(other.m_bufferPtr);
-        m_writeFence = std::move(other.m_writeFence);
-        m_readFence = std::move(other.m_readFence);
-        m_capacity = std::move(other.m_capacity);
-        m_index = std::move(other.m_index);
-        other.m_bufferID = 0;
-        other.m_bufferPtr = nullptr;
-        other.m_writeFence = nullptr;
-        other.m_readFence = nullptr;
-        other.m_capacity = 0;
-        other.m_index = 0;
+        if (&other != this) {
+            m_bufferID = std::move(other.m_bufferID);
+            m_bufferPtr = std::move(other.m_bufferPtr);
+            m_writeFence = std::move(other.m_writeFence);
+            m_readFence = std::move(other.m_readFence);
+            m_size = std::move(other.m_size);
+            m_capacity = std::move(other.m_capacity);
+            m_mapFlags = std::move(other.m_mapFlags);
+            m_fenceSite = other.m_fenceSite;
+            m_growthPolicy = other.m_growthPolicy;
+            m_dirty = std::move(other.m_dirty);
+            m_retired = std::move(other.m_retired);
+            other.m_bufferID = 0;
+            other.m_bufferPtr = nullptr;
+            other.m_writeFence = nullptr;
+            other.m_readFence = nullptr;
+            other.m_size = 0;
+            other.m_capacity = 0;
+        }
         return *this;
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Copy operator, for copying another buffer into this one.
     /// \param  other   another buffer to copy the data from, to here.
     glVector& operator=(const glVector& other) noexcept {
-        m_capacity = other.m_capacity;
-        glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, m_capacity);
+        if (&other != this) {
+            m_size = 0;
+            reserve(other.m_size);
+            m_size = other.m_size;
+            glCopyNamedBufferSubData(other.m_bufferID, m_bufferID, 0, 0, byteSize(m_size));
+            m_retired.fenceCopy(byteSize(m_size));
+        }
         return *this;
     }
     //////////////////////////////////////////////////////////////////////
-    /// \brief Retrieve a reference to the element at the index specified.
+    /// \brief  Retrieve a reference to the element at the index specified.
     /// \param  index   an index to the element desired.
     /// \return reference to the element desired.
-    T& operator[](const size_t index) noexcept { return m_bufferPtr[index]; }
+    T& operator[](const size_t index) noexcept {
+        touch(index, 1);
+        return m_bufferPtr[index];
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a const reference to the element at the index specified.
+    /// \note   Reads back through the mapping, requiring GL_MAP_READ_BIT.
+    /// \param  index   an index to the element desired.
+    /// \return const reference to the element desired.
+    const T& operator[](const size_t index) const noexcept {
+        m_retired.guard(byteSize(index));
+        return m_bufferPtr[index];
+    }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Resizes the internal capacity of this vector.
-    /// \note   Does nothing if the capacity is the same.
-    /// \note   Currently, only grows, never shrinks.
-    /// \note   May stall waiting for old buffers to finish, invalidate them.
-    /// \param	newCapacity		the new desired capacity.
-    void resize(const size_t newCapacity) noexcept {
-        // See if we must expand this container
-        if (newCapacity > m_capacity) {
-            // Calculate old and new byte sizes
-            const auto oldByteSize = sizeof(T) * m_capacity;
-            const auto newByteSize = sizeof(T) * newCapacity;
-            m_capacity = newCapacity;
+    /// \brief  Signal that this vector is finished being written to.
+    /// \note   Flushes the coalesced written ranges of a non-coherent mapping.
+    void endWriting() const noexcept {
+        m_dirty.flush(m_bufferID);
+        glBuffer::endWriting();
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Append an element to the end of this vector.
+    /// \note   Only reallocates when the capacity is exhausted.
+    /// \param  value   the element to append.
+    void push_back(const T& value) noexcept { emplace_back(value); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an element in place at the end of this vector.
+    /// \note   Only reallocates when the capacity is exhausted.
+    /// \param  args    the arguments to construct the element with.
+    /// \return reference to the new element.
+    template <typename... Args> T& emplace_back(Args&&... args) noexcept {
+        if (m_size == m_capacity)
+            grow(m_size + 1);
+        touch(m_size, 1);
+        T* element = new (m_bufferPtr + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *element;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove the last element of this vector.
+    void pop_back() noexcept {
+        if (m_size > 0)
+            --m_size;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove an element by moving the last element into its place.
+    /// \note   Doesn't preserve order. Reads the last element back through
+    ///         the mapping, requiring GL_MAP_READ_BIT.
+    /// \param  index   the index of the element to remove.
+    void swap_remove(const size_t index) noexcept {
+        if (index >= m_size)
+            return;
+        const size_t last = m_size - 1;
+        if (index != last) {
+            m_retired.guard(byteSize(last));
+            touch(index, 1);
+            m_bufferPtr[index] = m_bufferPtr[last];
+        }
+        --m_size;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove the element an iterator points to, swapping in the last element.
+    /// \param  position    iterator to the element to remove.
+    /// \return iterator to the element now occupying the removed position.
+    iterator erase(const_iterator position) noexcept {
+        const auto index = static_cast<size_t>(position - m_bufferPtr);
+        swap_remove(index);
+        return m_bufferPtr + index;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove every element, keeping the capacity.
+    void clear() noexcept { m_size = 0; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Change the number of elements in this vector.
+    /// \note   New elements are left uninitialized.
+    /// \param  newSize     the new element count.
+    void resize(const size_t newSize) noexcept {
+        if (newSize > m_capacity)
+            grow(newSize);
+        m_size = newSize;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Ensure this vector can hold at least the supplied elements without reallocating.
+    /// \param  newCapacity the capacity to reserve.
+    void reserve(const size_t newCapacity) noexcept {
+        if (newCapacity > m_capacity)
+            reallocate(newCapacity);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reallocate this vector's storage to fit only its elements.
+    void shrink_to_fit() noexcept {
+        if (std::max<size_t>(m_size, 1ULL) < m_capacity)
+            reallocate(std::max<size_t>(m_size, 1ULL));
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Set the policy used to pick a new capacity when growing.
+    /// \param  policy      the growth policy to use.
+    void setGrowthPolicy(const glGrowthPolicy policy) noexcept { m_growthPolicy = policy; }
 
-            // Wait for and transfer data from old buffers into new buffers
-            // of the new size
-            WaitForFence(m_writeFence);
-            WaitForFence(m_readFence);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve an iterator to the first element.
+    /// \note   Marks every element as written in an explicitly flushed mapping.
+    /// \return iterator to the beginning.
+    iterator begin() noexcept {
+        touch(0, m_size);
+        return m_bufferPtr;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve an iterator one past the last element.
+    /// \return iterator to the end.
+    iterator end() noexcept { return m_bufferPtr + m_size; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a const iterator to the first element.
+    /// \return const iterator to the beginning.
+    const_iterator begin() const noexcept { return cbegin(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a const iterator one past the last element.
+    /// \return const iterator to the end.
+    const_iterator end() const noexcept { return cend(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a const iterator to the first element.
+    /// \return const iterator to the beginning.
+    const_iterator cbegin() const noexcept {
+        m_retired.guard(0);
+        return m_bufferPtr;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a const iterator one past the last element.
+    /// \return const iterator to the end.
+    const_iterator cend() const noexcept { return m_bufferPtr + m_size; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a pointer to the mapped element storage.
+    /// \return pointer to the first element.
+    T* data() noexcept { return begin(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of elements in this vector.
+    /// \return the element count.
+    size_t size() const noexcept { return m_size; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of elements this vector can hold without reallocating.
+    /// \return the element capacity.
+    size_t capacity() const noexcept { return m_capacity; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether this vector has no elements.
+    /// \return true if empty, false otherwise.
+    bool empty() const noexcept { return m_size == 0; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the length of this vector (number of elements in it).
+    /// \return the number of elements in this array.
+    size_t getLength() const noexcept { return m_size; }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Convert an element count into a byte count.
+    /// \param  count       the number of elements.
+    /// \return the number of bytes.
+    constexpr static GLsizeiptr byteSize(const size_t count) noexcept {
+        return static_cast<GLsizeiptr>(sizeof(T) * count);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Prepare a range of elements for writing by the CPU.
+    /// \param  index       the first element to be written.
+    /// \param  count       the number of elements to be written.
+    void touch(const size_t index, const size_t count) noexcept {
+        m_retired.guard(byteSize(index));
+        if ((m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U)
+            m_dirty.add(byteSize(index), byteSize(count));
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Grow the capacity to fit the supplied element count, using the growth policy.
+    /// \param  required    the minimum capacity needed.
+    void grow(const size_t required) noexcept {
+        reallocate(static_cast<size_t>(
+            m_growthPolicy(static_cast<GLsizeiptr>(m_capacity), static_cast<GLsizeiptr>(required))));
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move this vector's elements into new storage of the supplied capacity.
+    /// \note   Never stalls, the old storage is retired until the GPU is done.
+    /// \param  newCapacity the new capacity, at least as large as the size.
+    void reallocate(const size_t newCapacity) noexcept {
+        // Release any old storage the GPU has finished with
+        m_retired.collect();
 
-            // Create new buffer
-            GLuint newBuffer = 0;
-            glCreateBuffers(1, &newBuffer);
-            glNamedBufferStorage(newBuffer, newByteSize, nullptr, GL_DYNAMIC_STORAGE_BIT | BufferFlags);
+        // Create new buffer, copying the live elements across
+        const GLuint newBuffer = createStorage(newCapacity);
+        m_dirty.flush(m_bufferID);
+        if (m_size != 0U)
+            glCopyNamedBufferSubData(m_bufferID, newBuffer, 0, 0, byteSize(m_size));
 
-            // Copy old buffer
-            if (oldByteSize)
-                glCopyNamedBufferSubData(m_bufferID, newBuffer, 0, 0, oldByteSize);
+        // The retirement fence follows every prior use of the old buffer
+        glDeleteSync(m_writeFence);
+        glDeleteSync(m_readFence);
+        m_writeFence = nullptr;
+        m_readFence = nullptr;
 
-            // Delete old buffer
-            glUnmapNamedBuffer(m_bufferID);
-            glDeleteBuffers(1, &m_bufferID);
+        // Retire old buffer rather than waiting on it
+        glUnmapNamedBuffer(m_bufferID);
+        MemoryRegistry::Unmap(MemoryRegistry::Category::Vector);
+        m_retired.retire(m_bufferID, byteSize(m_size), MemoryRegistry::Category::Vector, byteSize(m_capacity));
+        MemoryRegistry::Reallocate(MemoryRegistry::Category::Vector, byteSize(newCapacity), byteSize(m_size));
 
-            // Migrate new buffer
-            m_bufferID = newBuffer;
-            m_bufferPtr = (T*)(glMapNamedBufferRange(m_bufferID, 0, newByteSize, BufferFlags));
-        }
+        // Migrate new buffer
+        m_bufferID = newBuffer;
+        m_bufferPtr = mapStorage(m_bufferID, newCapacity);
+        m_capacity = newCapacity;
     }
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Retrieve the length of this vector (number of elements in it).
-    /// \return the number of elements in this array.
-    size_t getLength() const noexcept { return m_capacity; }
+    /// \brief  Create immutable storage for the supplied element capacity.
+    /// \param  capacity    the number of elements to allocate.
+    /// \return the new OpenGL buffer ID.
+    GLuint createStorage(const size_t capacity) const noexcept {
+        GLuint bufferID = 0;
+        glCreateBuffers(1, &bufferID);
+        glNamedBufferStorage(
+            bufferID, byteSize(capacity), nullptr, GL_DYNAMIC_STORAGE_BIT | StorageFlagsFromMapFlags(m_mapFlags));
+        return bufferID;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Persistently map the supplied buffer.
+    /// \param  bufferID    the buffer to map.
+    /// \param  capacity    the number of elements in the buffer.
+    /// \return pointer to the mapped elements.
+    T* mapStorage(const GLuint bufferID, const size_t capacity) const noexcept {
+        MemoryRegistry::Map(MemoryRegistry::Category::Vector);
+        return static_cast<T*>(glMapNamedBufferRange(bufferID, 0, byteSize(capacity), m_mapFlags));
+    }
 
-    private:
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    size_t m_capacity = 0;    ///< Byte-capacity of this buffer.
+    size_t m_size = 0;        ///< Number of elements in use.
+    size_t m_capacity = 0;    ///< Number of elements allocated.
     T* m_bufferPtr = nullptr; ///< Pointer to the underlying data.
-    constexpr GLbitfield BufferFlags =
-        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
+    GLbitfield m_mapFlags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                            GL_MAP_COHERENT_BIT;     ///< OpenGL map storage flags.
+    glGrowthPolicy m_growthPolicy = GeometricGrowth; ///< Picks the capacity to grow to.
+    mutable glDirtyRanges m_dirty;                   ///< Unflushed written ranges.
+    mutable glRetirementQueue m_retired;             ///< Storage replaced by reallocation.
 };
 }; // namespace mini
 
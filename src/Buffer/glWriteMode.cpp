@@ -0,0 +1,145 @@
+#include "Buffer/glWriteMode.hpp"
+#include "Buffer/glFence.hpp"
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glFence;
+using mini::glWriteMode;
+using mini::glWriteTracker;
+constexpr int ModeCount = static_cast<int>(glWriteMode::Count);
+constexpr size_t MaxInFlightRanges = 1024U;
+
+//////////////////////////////////////////////////////////////////////
+/// Statistics Storage
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+struct ModeCounters {
+    std::atomic<uint64_t> writes{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> overlaps{ 0 };
+};
+
+struct TrackerState {
+    std::atomic<bool> enabled{ false };
+    ModeCounters modes[ModeCount];
+};
+
+TrackerState& state() noexcept {
+    static TrackerState s_state;
+    return s_state;
+}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+/// Enabled
+//////////////////////////////////////////////////////////////////////
+
+bool glWriteTracker::Enabled() noexcept { return state().enabled.load(std::memory_order_relaxed); }
+
+//////////////////////////////////////////////////////////////////////
+/// SetEnabled
+//////////////////////////////////////////////////////////////////////
+
+void glWriteTracker::SetEnabled(const bool enabled) noexcept {
+    state().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Report
+//////////////////////////////////////////////////////////////////////
+
+glWriteTracker::ModeReport glWriteTracker::Report(const glWriteMode mode) noexcept {
+    const auto& counters = state().modes[static_cast<int>(mode)];
+    ModeReport report;
+    report.writes = counters.writes.load(std::memory_order_relaxed);
+    report.bytes = counters.bytes.load(std::memory_order_relaxed);
+    report.overlaps = counters.overlaps.load(std::memory_order_relaxed);
+    return report;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ResetStatistics
+//////////////////////////////////////////////////////////////////////
+
+void glWriteTracker::ResetStatistics() noexcept {
+    for (auto& counters : state().modes) {
+        counters.writes.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+        counters.overlaps.store(0, std::memory_order_relaxed);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ModeName
+//////////////////////////////////////////////////////////////////////
+
+const char* glWriteTracker::ModeName(const glWriteMode mode) noexcept {
+    switch (mode) {
+    case glWriteMode::Synchronized:
+        return "Synchronized";
+    case glWriteMode::InvalidateWhole:
+        return "InvalidateWhole";
+    case glWriteMode::InvalidateRange:
+        return "InvalidateRange";
+    case glWriteMode::Unsynchronized:
+        return "Unsynchronized";
+    default:
+        return "Unknown";
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// record
+//////////////////////////////////////////////////////////////////////
+
+bool glWriteTracker::record(const GLintptr offset, const GLsizeiptr size, const glWriteMode mode) {
+    // Anything issued since the last write may read it, so fence it now
+    if (m_hasPending) {
+        m_pending.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_inFlight.push_back(m_pending);
+        m_hasPending = false;
+    }
+
+    // Drop the ranges the GPU is done with, and the oldest if too many pile up
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (glFence::Poll(it->fence) || m_inFlight.size() > MaxInFlightRanges) {
+            glDeleteSync(it->fence);
+            it = m_inFlight.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    bool overlapped = false;
+    for (const auto& range : m_inFlight)
+        if (offset < range.end && range.offset < offset + size) {
+            overlapped = true;
+            break;
+        }
+
+    auto& counters = state().modes[static_cast<int>(mode)];
+    counters.writes.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+    if (overlapped)
+        counters.overlaps.fetch_add(1, std::memory_order_relaxed);
+
+    // Discarding the whole buffer leaves every in-flight read on the old storage
+    if (mode == glWriteMode::InvalidateWhole)
+        clear();
+    m_pending = Range{ offset, offset + size, nullptr };
+    m_hasPending = true;
+    return overlapped;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// clear
+//////////////////////////////////////////////////////////////////////
+
+void glWriteTracker::clear() noexcept {
+    for (auto& range : m_inFlight)
+        glDeleteSync(range.fence);
+    m_inFlight.clear();
+    m_hasPending = false;
+}
\ No newline at end of file
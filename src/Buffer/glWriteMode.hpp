@@ -0,0 +1,119 @@
+#pragma once
+#ifndef MINIGFX_GLWRITEMODE_HPP
+#define MINIGFX_GLWRITEMODE_HPP
+
+#include <cstdint>
+#include <glad/glad.h>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  How a buffer write treats data the GPU may still be reading.
+enum class glWriteMode : int {
+    Synchronized,    ///< Let the driver order the write after prior reads, which may stall or copy.
+    InvalidateWhole, ///< Discard the whole buffer first, so in-flight reads keep the old storage.
+    InvalidateRange, ///< Discard only the written range first, keeping the rest. Persistently mapped buffers
+                     ///< can't, so write in place like Unsynchronized rather than copy the whole buffer.
+    Unsynchronized,  ///< Write straight away, the caller guarantees no in-flight read overlaps.
+    Count            ///< Number of write modes.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \class  glWriteTracker
+/// \brief  Debug aid that detects buffer writes overlapping ranges the GPU may still be using,
+///         tallying writes and overlaps per write mode.
+/// \note   Only records anything while enabled, as it fences every tracked write.
+class glWriteTracker {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Statistics accumulated for one write mode.
+    struct ModeReport {
+        uint64_t writes = 0ULL;   ///< Number of tracked writes.
+        uint64_t bytes = 0ULL;    ///< Number of bytes written.
+        uint64_t overlaps = 0ULL; ///< Writes that overlapped an in-flight range.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Release any fences still held.
+    ~glWriteTracker() { clear(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Default constructor.
+    glWriteTracker() = default;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another tracker to move from.
+    glWriteTracker(glWriteTracker&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another tracker into this one.
+    /// \param  other   another tracker to move the data from, to here.
+    glWriteTracker& operator=(glWriteTracker&& other) noexcept {
+        if (&other != this) {
+            std::swap(m_inFlight, other.m_inFlight);
+            std::swap(m_pending, other.m_pending);
+            std::swap(m_hasPending, other.m_hasPending);
+        }
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether writes are being tracked.
+    /// \return true if tracking is enabled.
+    static bool Enabled() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Enable or disable write tracking for every buffer.
+    /// \param  enabled     whether to track writes.
+    static void SetEnabled(const bool enabled) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy the statistics of a write mode.
+    /// \param  mode    the write mode to report on.
+    /// \return the mode's statistics.
+    static ModeReport Report(const glWriteMode mode) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Zero the statistics of every write mode.
+    static void ResetStatistics() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the name of a write mode.
+    /// \param  mode    the write mode to name.
+    /// \return the mode's name.
+    static const char* ModeName(const glWriteMode mode) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record a write about to be made, checking it against in-flight ranges.
+    /// \note   Any commands issued since the previous write may be using its range,
+    ///         which stays in flight until a fence placed now has signaled.
+    /// \param  offset      byte offset of the write.
+    /// \param  size        byte-size of the write.
+    /// \param  mode        the write mode used.
+    /// \return true if the write overlapped an in-flight range.
+    bool record(const GLintptr offset, const GLsizeiptr size, const glWriteMode mode);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Forget every in-flight range, e.g. once the storage was replaced.
+    void clear() noexcept;
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glWriteTracker(const glWriteTracker&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glWriteTracker& operator=(const glWriteTracker&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A written byte range the GPU may still be using.
+    struct Range {
+        GLintptr offset = 0;    ///< First byte of the range.
+        GLintptr end = 0;       ///< One past the last byte of the range.
+        GLsync fence = nullptr; ///< Signals once every command that could use the range is done.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<Range> m_inFlight; ///< Fenced ranges, oldest first.
+    Range m_pending;               ///< The last write, not yet fenced.
+    bool m_hasPending = false;     ///< Whether m_pending holds a write.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLWRITEMODE_HPP
\ No newline at end of file
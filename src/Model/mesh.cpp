@@ -0,0 +1,96 @@
+#include "Model/mesh.hpp"
+#include <cstdint>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::Mesh;
+using mini::vec3;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static void position_key(const vec3& /*position*/, uint32_t (&/*key*/)[3]) noexcept;
+static uint32_t hash_key(const uint32_t (&/*key*/)[3]) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// weldVertices
+//////////////////////////////////////////////////////////////////////
+
+Mesh mini::weldVertices(const std::vector<vec3>& soup) {
+    Mesh mesh;
+    mesh.indices.reserve(soup.size());
+
+    // Open addressing at under 50% load, each slot holds a unique vertex index plus one
+    size_t tableSize = 16U;
+    while (tableSize < soup.size() * 2U)
+        tableSize *= 2U;
+    std::vector<GLuint> table(tableSize, 0U);
+    std::vector<uint32_t> keys;
+    keys.reserve(soup.size() * 3U);
+    const auto mask = tableSize - 1U;
+
+    for (const auto& position : soup) {
+        uint32_t key[3];
+        position_key(position, key);
+        auto slot = static_cast<size_t>(hash_key(key)) & mask;
+        while (true) {
+            const auto entry = table[slot];
+            if (entry == 0U) {
+                // First time seen, append it as a new unique vertex
+                const auto index = static_cast<GLuint>(mesh.vertices.size());
+                table[slot] = index + 1U;
+                mesh.vertices.push_back(position);
+                keys.insert(keys.end(), { key[0], key[1], key[2] });
+                mesh.indices.push_back(index);
+                break;
+            }
+            const auto* existing = &keys[(entry - 1U) * 3U];
+            if (existing[0] == key[0] && existing[1] == key[1] && existing[2] == key[2]) {
+                mesh.indices.push_back(entry - 1U);
+                break;
+            }
+            slot = (slot + 1U) & mask;
+        }
+    }
+    return mesh;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// PackIndices
+//////////////////////////////////////////////////////////////////////
+
+std::vector<unsigned char> mini::PackIndices(const std::vector<GLuint>& indices, const GLenum indexType) {
+    std::vector<unsigned char> packed(indices.size() * IndexTypeSize(indexType));
+    if (indexType == GL_UNSIGNED_SHORT) {
+        for (size_t x = 0; x < indices.size(); ++x) {
+            const auto index = static_cast<uint16_t>(indices[x]);
+            std::memcpy(&packed[x * 2U], &index, 2U);
+        }
+    } else if (!indices.empty())
+        std::memcpy(packed.data(), indices.data(), packed.size());
+    return packed;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// position_key
+//////////////////////////////////////////////////////////////////////
+
+static void position_key(const vec3& position, uint32_t (&key)[3]) noexcept {
+    for (size_t x = 0; x < 3U; ++x) {
+        // Fold -0.0 into +0.0 so they weld together
+        const float value = position[x] == 0.0F ? 0.0F : position[x];
+        std::memcpy(&key[x], &value, sizeof(float));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// hash_key
+//////////////////////////////////////////////////////////////////////
+
+static uint32_t hash_key(const uint32_t (&key)[3]) noexcept {
+    // Large odd multipliers spread nearby float bit patterns across the table
+    uint32_t hash = key[0] * 73856093U;
+    hash ^= key[1] * 19349663U;
+    hash ^= key[2] * 83492791U;
+    return hash ^ (hash >> 16U);
+}
\ No newline at end of file
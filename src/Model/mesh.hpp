@@ -0,0 +1,54 @@
+#pragma once
+#ifndef MINIGFX_MESH_HPP
+#define MINIGFX_MESH_HPP
+
+#include "Utility/vec.hpp"
+#include <glad/glad.h>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \struct Mesh
+/// \brief  Geometry as unique vertices plus triangle indices into them.
+struct Mesh {
+    std::vector<vec3> vertices;  ///< The unique vertices.
+    std::vector<GLuint> indices; ///< Indices into the vertices, 3 per triangle, empty if not indexed.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether this mesh is drawn through indices.
+    /// \return true if there are any indices.
+    bool indexed() const noexcept { return !indices.empty(); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how many elements a draw of this mesh consumes.
+    /// \return the index count, or the vertex count if not indexed.
+    size_t elementCount() const noexcept { return indexed() ? indices.size() : vertices.size(); }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Merge bit-identical vertices of a triangle soup, hashing each position once.
+/// \note   Positive and negative zero are treated as the same coordinate.
+/// \param  soup    the vertices to weld, 3 per triangle.
+/// \return the unique vertices, in first-seen order, and an index per soup vertex.
+Mesh weldVertices(const std::vector<vec3>& soup);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Pick the smallest index type able to address a vertex count.
+/// \param  vertexCount the number of vertices the indices refer to.
+/// \return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+constexpr GLenum IndexTypeFor(const size_t vertexCount) noexcept {
+    return vertexCount <= 65536U ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+//////////////////////////////////////////////////////////////////////
+/// \brief  Retrieve the byte-size of an index type.
+/// \param  indexType   GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+/// \return the size of one index.
+constexpr size_t IndexTypeSize(const GLenum indexType) noexcept { return indexType == GL_UNSIGNED_SHORT ? 2U : 4U; }
+//////////////////////////////////////////////////////////////////////
+/// \brief  Narrow indices to the index type provided, packing them as raw bytes.
+/// \param  indices     the indices to pack.
+/// \param  indexType   GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+/// \return the packed indices.
+std::vector<unsigned char> PackIndices(const std::vector<GLuint>& indices, const GLenum indexType);
+}; // namespace mini
+
+#endif // MINIGFX_MESH_HPP
\ No newline at end of file
@@ -0,0 +1,388 @@
+#include "Model/meshCache.hpp"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::MeshCache;
+using mini::PositionEncoding;
+using mini::VertexLayout;
+constexpr char Magic[8] = { 'M', 'I', 'N', 'I', 'M', 'E', 'S', 'H' };
+constexpr uint64_t HashSeed = 0xCBF29CE484222325ULL;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The fixed-size start of every cache file.
+struct FileHeader {
+    char magic[8];             ///< Always Magic.
+    uint32_t version;          ///< The cache version the file was written with.
+    uint32_t headerBytes;      ///< Byte-size of this header.
+    uint64_t checksum;         ///< Hash of every byte after this field.
+    uint64_t fileBytes;        ///< Byte-size of the whole file.
+    uint32_t layout;           ///< The vertex layout.
+    uint32_t stride;           ///< Bytes per vertex.
+    uint32_t attributeCount;   ///< Number of attribute records following the header.
+    uint32_t entryCount;       ///< Number of entry records following the attributes.
+    uint64_t vertexCount;      ///< Number of vertices in the vertex blob.
+    uint64_t vertexOffset;     ///< Byte offset of the vertex blob.
+    uint64_t vertexBytes;      ///< Byte-size of the vertex blob.
+    uint64_t indexOffset;      ///< Byte offset of the index blob.
+    uint64_t indexBytes;       ///< Byte-size of the index blob.
+    uint32_t positionEncoding; ///< How positions are stored.
+    float positionOffset[3];   ///< Added to each position attribute.
+    float positionScale[3];    ///< Multiplies each position attribute.
+    uint32_t lodEntries;       ///< 1 if the entries are one model's levels of detail, 0 otherwise.
+    float boundsCenter[3];     ///< Center of a sphere bounding the vertices.
+    float boundsRadius;        ///< Radius of a sphere bounding the vertices.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A stored vertex attribute.
+struct AttributeRecord {
+    int32_t components;  ///< Number of components fetched.
+    uint32_t type;       ///< The type of each component.
+    uint32_t normalized; ///< Whether integer components are normalized.
+    uint32_t integer;    ///< Whether the shader reads integers.
+    uint32_t size;       ///< Bytes occupied per vertex.
+    uint32_t offset;     ///< Bytes of all earlier attributes per vertex.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A stored model entry.
+struct EntryRecord {
+    int32_t offset;      ///< First vertex.
+    int32_t count;       ///< Number of vertices.
+    int64_t indexOffset; ///< Byte offset of the first index within the index blob.
+    int32_t indexCount;  ///< Number of indices.
+    uint32_t indexType;  ///< The type of each index.
+    float lodError;      ///< How far this level of detail may deviate from the finest, 0 if not a level.
+    uint32_t reserved;   ///< Padding, always 0.
+};
+
+// Records stay multiples of 8 bytes, so the tables and the checksummed range stay word aligned
+static_assert(sizeof(FileHeader) % 8U == 0U, "The header must be a multiple of 8 bytes.");
+static_assert(sizeof(AttributeRecord) % 8U == 0U, "Attribute records must be a multiple of 8 bytes.");
+static_assert(sizeof(EntryRecord) % 8U == 0U, "Entry records must be a multiple of 8 bytes.");
+constexpr size_t HashedFrom = offsetof(FileHeader, checksum) + sizeof(uint64_t);
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A checksum fed in pieces of any size, matching a single hash_words() pass over them all.
+struct RunningHash {
+    uint64_t hash = HashSeed;      ///< The hash of every whole word so far.
+    unsigned char pending[8] = {}; ///< Bytes of the word still being gathered.
+    size_t pendingBytes = 0U;      ///< Number of pending bytes.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static uint64_t hash_words(uint64_t /*hash*/, const void* /*data*/, const size_t /*size*/) noexcept;
+static size_t align_up(const size_t /*value*/, const size_t /*alignment*/) noexcept;
+static void hash_append(RunningHash& /*running*/, const void* /*data*/, size_t /*size*/) noexcept;
+static bool write_hashed(
+    std::ofstream& /*file*/, RunningHash& /*running*/, const void* /*data*/, const size_t /*size*/);
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Destructor
+//////////////////////////////////////////////////////////////////////
+
+MeshCache::~MeshCache() { close(); }
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+MeshCache& MeshCache::operator=(MeshCache&& p) noexcept {
+    if (&p != this) {
+        std::swap(m_data, p.m_data);
+        std::swap(m_size, p.m_size);
+        std::swap(m_contents, p.m_contents);
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// open
+//////////////////////////////////////////////////////////////////////
+
+bool MeshCache::open(const std::string& path, const bool verify) {
+    close();
+#if defined(_WIN32)
+    // The view keeps the mapping alive, so both handles can be closed straight away
+    const auto file = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) != 0 && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+        m_data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size = static_cast<size_t>(size.QuadPart);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    // The mapping outlives the descriptor, so it can be closed straight away
+    const auto file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat status {};
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        const auto size = static_cast<size_t>(status.st_size);
+        auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, size, MADV_WILLNEED);
+            m_data = static_cast<const unsigned char*>(data);
+            m_size = size;
+        }
+    }
+    ::close(file);
+#endif
+    if (m_data == nullptr || !parse(verify)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// close
+//////////////////////////////////////////////////////////////////////
+
+void MeshCache::close() noexcept {
+    if (m_data != nullptr) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0U;
+    m_contents = Contents{};
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Write
+//////////////////////////////////////////////////////////////////////
+
+bool MeshCache::Write(const std::string& path, const Contents& contents) {
+    // Lay the file out, tables first, then each blob on its own alignment boundary
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.headerBytes = static_cast<uint32_t>(sizeof(FileHeader));
+    header.layout = static_cast<uint32_t>(contents.format.layout);
+    header.stride = static_cast<uint32_t>(contents.format.stride);
+    header.attributeCount = static_cast<uint32_t>(contents.format.attributes.size());
+    header.entryCount = static_cast<uint32_t>(contents.entries.size());
+    header.vertexCount = contents.vertexCount;
+    header.vertexBytes = static_cast<uint64_t>(contents.format.stride) * contents.vertexCount;
+    header.vertexOffset = align_up(
+        sizeof(FileHeader) + (sizeof(AttributeRecord) * header.attributeCount)
+            + (sizeof(EntryRecord) * header.entryCount),
+        BlobAlignment);
+    header.indexOffset = align_up(header.vertexOffset + header.vertexBytes, BlobAlignment);
+    header.indexBytes = contents.indexBytes;
+    header.fileBytes = align_up(header.indexOffset + header.indexBytes, 8U);
+    header.positionEncoding = static_cast<uint32_t>(contents.positionEncoding);
+    for (int x = 0; x < 3; ++x) {
+        header.positionOffset[x] = contents.positionOffset[x];
+        header.positionScale[x] = contents.positionScale[x];
+        header.boundsCenter[x] = contents.boundsCenter[x];
+    }
+    header.boundsRadius = contents.boundsRadius;
+    const auto lodEntries = !contents.lodErrors.empty() && contents.lodErrors.size() == contents.entries.size();
+    header.lodEntries = lodEntries ? 1U : 0U;
+
+    std::vector<AttributeRecord> attributes;
+    for (const auto& attribute : contents.format.attributes)
+        attributes.push_back(
+            { attribute.components, attribute.type, attribute.normalized, attribute.integer ? 1U : 0U, attribute.size,
+              attribute.offset });
+    std::vector<EntryRecord> entries;
+    for (size_t x = 0; x < contents.entries.size(); ++x) {
+        const auto& entry = contents.entries[x];
+        entries.push_back(
+            { entry.offset, entry.count, static_cast<int64_t>(entry.indexOffset), entry.indexCount, entry.indexType,
+              lodEntries ? contents.lodErrors[x] : 0.0F, 0U });
+    }
+
+    // Write every section, hashing as we go, then go back and fill in the checksum
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    const std::vector<unsigned char> padding(BlobAlignment, 0U);
+    RunningHash running;
+    const auto* headerBytes = reinterpret_cast<const unsigned char*>(&header);
+    file.write(reinterpret_cast<const char*>(headerBytes), HashedFrom);
+    const auto tables = sizeof(AttributeRecord) * attributes.size() + sizeof(EntryRecord) * entries.size();
+    const auto vertexEnd = header.vertexOffset + header.vertexBytes;
+    const auto indexEnd = header.indexOffset + header.indexBytes;
+    if (!write_hashed(file, running, headerBytes + HashedFrom, sizeof(FileHeader) - HashedFrom)
+        || !write_hashed(file, running, attributes.data(), sizeof(AttributeRecord) * attributes.size())
+        || !write_hashed(file, running, entries.data(), sizeof(EntryRecord) * entries.size())
+        || !write_hashed(file, running, padding.data(), header.vertexOffset - sizeof(FileHeader) - tables)
+        || !write_hashed(file, running, contents.vertexData, header.vertexBytes)
+        || !write_hashed(file, running, padding.data(), header.indexOffset - vertexEnd)
+        || !write_hashed(file, running, contents.indexData, header.indexBytes)
+        || !write_hashed(file, running, padding.data(), header.fileBytes - indexEnd))
+        return false;
+    file.seekp(static_cast<std::streamoff>(offsetof(FileHeader, checksum)));
+    file.write(reinterpret_cast<const char*>(&running.hash), sizeof(running.hash));
+    return static_cast<bool>(file);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// parse
+//////////////////////////////////////////////////////////////////////
+
+bool MeshCache::parse(const bool verify) {
+    FileHeader header;
+    if (m_size < sizeof(FileHeader))
+        return false;
+    std::memcpy(&header, m_data, sizeof(FileHeader));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version
+        || header.headerBytes != sizeof(FileHeader) || header.fileBytes != m_size || m_size % 8U != 0U
+        || header.layout > static_cast<uint32_t>(VertexLayout::Separate)
+        || header.positionEncoding > static_cast<uint32_t>(PositionEncoding::Unorm16) || header.lodEntries > 1U)
+        return false;
+
+    // Every range must lie within the file, the blobs after the tables and on their alignment. Sizes are compared
+    // against what's left past each offset, as forged offsets could wrap any sum around
+    const auto tablesEnd = sizeof(FileHeader) + (sizeof(AttributeRecord) * uint64_t{ header.attributeCount })
+                           + (sizeof(EntryRecord) * uint64_t{ header.entryCount });
+    if (header.attributeCount == 0U || tablesEnd > m_size || header.vertexOffset < tablesEnd
+        || header.vertexOffset > m_size || header.indexOffset > m_size || header.vertexOffset % BlobAlignment != 0U
+        || header.indexOffset % BlobAlignment != 0U || header.vertexBytes > m_size - header.vertexOffset
+        || header.indexBytes > m_size - header.indexOffset || header.vertexBytes > header.indexOffset
+        || header.vertexOffset > header.indexOffset - header.vertexBytes
+        || (header.vertexCount != 0U && header.stride > header.vertexBytes / header.vertexCount)
+        || header.vertexBytes != uint64_t{ header.stride } * header.vertexCount)
+        return false;
+    if (verify && hash_words(HashSeed, m_data + HashedFrom, m_size - HashedFrom) != header.checksum)
+        return false;
+
+    Contents contents;
+    contents.format.layout = static_cast<VertexLayout>(header.layout);
+    contents.format.stride = static_cast<GLsizei>(header.stride);
+    const auto* attributes = reinterpret_cast<const AttributeRecord*>(m_data + sizeof(FileHeader));
+    for (uint32_t x = 0; x < header.attributeCount; ++x) {
+        AttributeRecord record;
+        std::memcpy(&record, &attributes[x], sizeof(record));
+        if (uint64_t{ record.offset } + record.size > header.stride)
+            return false;
+        contents.format.attributes.push_back(
+            { record.components, record.type, static_cast<GLboolean>(record.normalized), record.integer != 0U,
+              record.size, record.offset });
+    }
+    const auto* entries = reinterpret_cast<const EntryRecord*>(attributes + header.attributeCount);
+    contents.entries.reserve(header.entryCount);
+    for (uint32_t x = 0; x < header.entryCount; ++x) {
+        EntryRecord record;
+        std::memcpy(&record, &entries[x], sizeof(record));
+        const auto indexSize = static_cast<int64_t>(mini::IndexTypeSize(record.indexType));
+        const auto vertexEnd = static_cast<uint64_t>(record.offset) + static_cast<uint64_t>(record.count);
+        const auto indexEnd = static_cast<uint64_t>(record.indexOffset)
+                              + (static_cast<uint64_t>(record.indexCount) * static_cast<uint64_t>(indexSize));
+        if (record.offset < 0 || record.count < 0 || vertexEnd > header.vertexCount || record.indexCount < 0)
+            return false;
+        if (record.indexCount != 0
+            && ((record.indexType != GL_UNSIGNED_SHORT && record.indexType != GL_UNSIGNED_INT)
+                || record.indexOffset < 0 || record.indexOffset % indexSize != 0 || indexEnd > header.indexBytes))
+            return false;
+        contents.entries.push_back(
+            { record.offset, record.count, static_cast<GLintptr>(record.indexOffset), record.indexCount,
+              record.indexType });
+        if (header.lodEntries != 0U)
+            contents.lodErrors.push_back(record.lodError);
+    }
+
+    contents.vertexCount = static_cast<size_t>(header.vertexCount);
+    contents.vertexData = m_data + header.vertexOffset;
+    contents.indexData = header.indexBytes != 0U ? m_data + header.indexOffset : nullptr;
+    contents.indexBytes = static_cast<size_t>(header.indexBytes);
+    contents.positionEncoding = static_cast<PositionEncoding>(header.positionEncoding);
+    for (int x = 0; x < 3; ++x) {
+        contents.positionOffset[x] = header.positionOffset[x];
+        contents.positionScale[x] = header.positionScale[x];
+        contents.boundsCenter[x] = header.boundsCenter[x];
+    }
+    contents.boundsRadius = header.boundsRadius;
+    m_contents = std::move(contents);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// hash_words
+//////////////////////////////////////////////////////////////////////
+
+static uint64_t hash_words(uint64_t hash, const void* data, const size_t size) noexcept {
+    // FNV-style multiply per 64-bit word, with a shift folding the high bits back down
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t x = 0; x + 8U <= size; x += 8U) {
+        uint64_t word;
+        std::memcpy(&word, bytes + x, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29U;
+    }
+    return hash;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// hash_append
+//////////////////////////////////////////////////////////////////////
+
+static void hash_append(RunningHash& running, const void* data, size_t size) noexcept {
+    // Complete any partial word first, hash whole words in place, then keep the remainder for later
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    while (size != 0U && running.pendingBytes != 0U) {
+        running.pending[running.pendingBytes++] = *bytes++;
+        --size;
+        if (running.pendingBytes == 8U) {
+            running.hash = hash_words(running.hash, running.pending, 8U);
+            running.pendingBytes = 0U;
+        }
+    }
+    const auto whole = size & ~size_t{ 7U };
+    running.hash = hash_words(running.hash, bytes, whole);
+    std::memcpy(running.pending, bytes + whole, size - whole);
+    running.pendingBytes = size - whole;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// align_up
+//////////////////////////////////////////////////////////////////////
+
+static size_t align_up(const size_t value, const size_t alignment) noexcept {
+    return ((value + alignment - 1U) / alignment) * alignment;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// write_hashed
+//////////////////////////////////////////////////////////////////////
+
+static bool write_hashed(std::ofstream& file, RunningHash& running, const void* data, const size_t size) {
+    if (size == 0U)
+        return true;
+    if (data == nullptr)
+        return false;
+    hash_append(running, data, size);
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef MINIGFX_MESHCACHE_HPP
+#define MINIGFX_MESHCACHE_HPP
+
+#include "Model/modelGroup.hpp"
+#include "Model/vertexFormat.hpp"
+#include "Model/vertexQuantization.hpp"
+#include "Utility/vec.hpp"
+#include <cstdint>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  MeshCache
+/// \brief  A memory-mapped binary container of GPU-ready vertex and index data.
+/// \note   Files hold a header, an attribute and entry table, then vertex and index blobs aligned to
+///         BlobAlignment, all in native byte order and covered by a checksum.
+class MeshCache {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  The version written to, and required of, every file.
+    static constexpr uint32_t Version = 2U;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  The byte alignment of each blob within the file.
+    static constexpr size_t BlobAlignment = 256U;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Everything stored in a cache, with the blobs pointing into the mapped file once opened.
+    struct Contents {
+        VertexDescription format;                                      ///< The format and layout of the vertices.
+        size_t vertexCount = 0U;                                       ///< The number of vertices.
+        const void* vertexData = nullptr;                              ///< The vertices, packed in the format.
+        const void* indexData = nullptr;                               ///< Every entry's packed indices.
+        size_t indexBytes = 0U;                                        ///< Byte-size of the index data.
+        std::vector<ModelGroup::GroupEntry> entries;                   ///< Each model's ranges within the blobs.
+        PositionEncoding positionEncoding = PositionEncoding::Float32; ///< How positions are stored.
+        vec3 positionOffset = vec3(0.0F);                              ///< Added to each position attribute.
+        vec3 positionScale = vec3(1.0F);                               ///< Multiplies each position attribute.
+        std::vector<float> lodErrors;                                  ///< Each level's error, if entries are levels.
+        vec3 boundsCenter = vec3(0.0F);                                ///< Center of the vertices' bounding sphere.
+        float boundsRadius = 0.0F;                                     ///< Radius of the vertices' bounding sphere.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Unmap the file, if open.
+    ~MeshCache();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Default Constructor.
+    MeshCache() = default;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    MeshCache(MeshCache&& o) noexcept { (*this) = std::move(o); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move-assignment operator.
+    MeshCache& operator=(MeshCache&& p) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Map a cache file and validate its header, tables and ranges.
+    /// \note   The blobs are used in place, nothing is copied out of the mapping.
+    /// \param  path        the file to open.
+    /// \param  verify      whether to also check every byte against the checksum.
+    /// \return true if the file is a valid cache of this version.
+    bool open(const std::string& path, const bool verify = true);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Unmap the file, invalidating the contents.
+    void close() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether a file is open.
+    /// \return true if open() succeeded and close() wasn't called since.
+    bool isOpen() const noexcept { return m_data != nullptr; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the contents of the open file.
+    /// \return the contents, empty if not open.
+    const Contents& contents() const noexcept { return m_contents; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write a cache file.
+    /// \param  path        the file to write, replaced if it exists.
+    /// \param  contents    the vertex and index data and entries to store.
+    /// \return true on success.
+    static bool Write(const std::string& path, const Contents& contents);
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    MeshCache(const MeshCache& o) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    MeshCache& operator=(const MeshCache& p) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check the mapped file and point the contents into it.
+    /// \param  verify      whether to also check every byte against the checksum.
+    /// \return true if the file is valid.
+    bool parse(const bool verify);
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    const unsigned char* m_data = nullptr; ///< The start of the mapped file.
+    size_t m_size = 0U;                    ///< Byte-size of the mapped file.
+    Contents m_contents;                   ///< The contents, pointing into the mapped file.
+};
+}; // namespace mini
+
+#endif // MINIGFX_MESHCACHE_HPP
\ No newline at end of file
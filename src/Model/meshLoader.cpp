@@ -0,0 +1,782 @@
+#include "Model/meshLoader.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::Mesh;
+using mini::MeshLoader;
+using mini::vec3;
+constexpr ptrdiff_t ChunkBytes = 1 << 20;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A face index before the chunks of a file are stitched together.
+struct FaceIndex {
+    int64_t value = 0;     ///< The vertex index, 0-based.
+    bool relative = false; ///< Whether the index counts from the first vertex of its chunk.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A line-aligned range of a file, parsed as a unit.
+struct FileChunk {
+    const char* begin = nullptr; ///< The first byte of the range.
+    const char* end = nullptr;   ///< One past the last byte of the range.
+    size_t element = 0U;         ///< The PLY element the range holds rows of.
+    size_t rows = 0U;            ///< The number of PLY rows in the range.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The geometry parsed out of a single chunk.
+struct ChunkResult {
+    std::vector<vec3> vertices;     ///< Vertices, in file order.
+    std::vector<FaceIndex> indices; ///< Triangle indices, 3 per triangle.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The storage layout of a PLY file's body.
+enum class PlyFormat { Ascii, BinaryLittleEndian, BinaryBigEndian };
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The numeric types a PLY property can hold.
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A single property of a PLY element.
+struct PlyProperty {
+    std::string name;                 ///< The property's name.
+    PlyType type = PlyType::Invalid;  ///< The value type, or the item type of a list.
+    PlyType count = PlyType::Invalid; ///< The type of a list's length, invalid if not a list.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A PLY element, made of rows of properties.
+struct PlyElement {
+    std::string name;                    ///< The element's name.
+    size_t rows = 0U;                    ///< The number of rows.
+    std::vector<PlyProperty> properties; ///< The properties of each row, in order.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A parsed PLY header.
+struct PlyHeader {
+    PlyFormat format = PlyFormat::Ascii; ///< How the body is stored.
+    std::vector<PlyElement> elements;    ///< Every element, in file order.
+    size_t body = 0U;                    ///< Byte offset of the body.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A file being loaded, shared between the tasks parsing its chunks.
+struct ParseJob {
+    size_t ticket = 0U;                  ///< The load's ticket.
+    std::string path;                    ///< The file's path.
+    size_t generation = 0U;              ///< The cancellation generation the load was requested in.
+    std::vector<char> bytes;             ///< The file's contents.
+    bool ply = false;                    ///< Whether the file is a PLY rather than an OBJ.
+    PlyHeader header;                    ///< The PLY header, if a PLY.
+    std::vector<FileChunk> chunks;       ///< The chunks to parse.
+    std::vector<ChunkResult> results;    ///< The geometry of each chunk.
+    std::atomic<size_t> remaining{ 0U }; ///< Chunks not yet parsed.
+    std::atomic<bool> failed{ false };   ///< Whether any chunk failed to parse.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static bool read_file(const std::string& /*path*/, std::vector<char>& /*bytes*/);
+static bool split_file(ParseJob& /*job*/);
+static bool parse_chunk(ParseJob& /*job*/, const size_t /*chunk*/);
+static bool merge_chunks(const std::vector<ChunkResult>& /*results*/, Mesh& /*mesh*/);
+static bool split_obj(const char* /*data*/, const size_t /*size*/, std::vector<FileChunk>& /*chunks*/);
+static bool parse_obj_chunk(const FileChunk& /*chunk*/, ChunkResult& /*result*/);
+static bool parse_ply_header(const char* /*data*/, const size_t /*size*/, PlyHeader& /*header*/);
+static bool split_ply(
+    const char* /*data*/, const size_t /*size*/, const PlyHeader& /*header*/, std::vector<FileChunk>& /*chunks*/);
+static bool parse_ply_chunk(const PlyHeader& /*header*/, const FileChunk& /*chunk*/, ChunkResult& /*result*/);
+static bool skip_ply_row(
+    const PlyFormat /*format*/, const PlyElement& /*element*/, const char*& /*cursor*/, const char* /*end*/);
+static bool read_ply_value(
+    const PlyFormat /*format*/, const PlyType /*type*/, const char*& /*cursor*/, const char* /*end*/,
+    double& /*value*/);
+static PlyType ply_type(const std::string& /*name*/) noexcept;
+static size_t ply_type_size(const PlyType /*type*/) noexcept;
+static void fan_triangulate(const std::vector<FaceIndex>& /*polygon*/, std::vector<FaceIndex>& /*indices*/);
+static void skip_space(const char*& /*cursor*/, const char* /*end*/) noexcept;
+static const char* next_line(const char* /*cursor*/, const char* /*end*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Destructor
+//////////////////////////////////////////////////////////////////////
+
+MeshLoader::~MeshLoader() {
+    // Outstanding tasks see the new generation and bail out early
+    cancel();
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_stopping = true;
+    }
+    m_taskSignal.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Constructor
+//////////////////////////////////////////////////////////////////////
+
+MeshLoader::MeshLoader(const size_t threadCount) {
+    auto count = threadCount;
+    if (count == 0U)
+        count = std::max(2U, std::thread::hardware_concurrency()) - 1U;
+    m_workers.reserve(count);
+    for (size_t x = 0; x < count; ++x)
+        m_workers.emplace_back([this] { work(); });
+}
+
+//////////////////////////////////////////////////////////////////////
+/// load
+//////////////////////////////////////////////////////////////////////
+
+size_t MeshLoader::load(const std::string& path) {
+    auto job = std::make_shared<ParseJob>();
+    job->ticket = ++m_nextTicket;
+    job->path = path;
+    job->generation = m_generation;
+    ++m_requested;
+
+    // Read and split the file on a worker, then parse every chunk on whichever worker is free
+    schedule([this, job] {
+        if (job->generation != m_generation || !read_file(job->path, job->bytes) || !split_file(*job)
+            || job->chunks.empty()) {
+            finish(job->ticket, job->path, job->generation, false, Mesh{});
+            return;
+        }
+        job->results.resize(job->chunks.size());
+        job->remaining = job->chunks.size();
+        for (size_t x = 0; x < job->chunks.size(); ++x)
+            schedule([this, job, x] {
+                if (job->generation == m_generation && !job->failed && !parse_chunk(*job, x))
+                    job->failed = true;
+                if (--job->remaining != 0U)
+                    return;
+
+                // The last chunk to finish stitches the mesh together
+                Mesh mesh;
+                const auto success =
+                    job->generation == m_generation && !job->failed && merge_chunks(job->results, mesh);
+                finish(job->ticket, job->path, job->generation, success, std::move(mesh));
+            });
+    });
+    return job->ticket;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// pump
+//////////////////////////////////////////////////////////////////////
+
+std::vector<MeshLoader::Result> MeshLoader::pump(ModelGroup& group, const size_t maxMeshes) {
+    std::vector<Finished> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        while (!m_finished.empty() && batch.size() < maxMeshes) {
+            batch.push_back(std::move(m_finished.front()));
+            m_finished.pop_front();
+        }
+    }
+
+    // Upload every parsed mesh together
+    std::vector<Mesh> meshes;
+    for (auto& finished : batch)
+        if (finished.success)
+            meshes.push_back(std::move(finished.mesh));
+    const auto entries = group.addModels(meshes);
+
+    // Meshes the group couldn't take, e.g. empty or of another format, fail rather than count as uploaded
+    std::vector<Result> results;
+    results.reserve(batch.size());
+    size_t uploaded = 0U;
+    for (const auto& finished : batch) {
+        Result result{ finished.ticket, finished.path, false, {} };
+        if (finished.success) {
+            result.entry = entries[uploaded++];
+            result.success = result.entry.count != 0;
+            if (result.success) {
+                ++m_uploaded;
+            } else {
+                --m_parsed;
+                ++m_failed;
+            }
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// cancel
+//////////////////////////////////////////////////////////////////////
+
+void MeshLoader::cancel() {
+    // Bump the generation under the same lock finish() checks it with, so nothing stale slips in after
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    ++m_generation;
+    for (const auto& finished : m_finished) {
+        if (finished.success)
+            --m_parsed;
+        else
+            --m_failed;
+        ++m_cancelled;
+    }
+    m_finished.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// progress
+//////////////////////////////////////////////////////////////////////
+
+MeshLoader::Progress MeshLoader::progress() const noexcept {
+    return { m_requested, m_parsed, m_failed, m_cancelled, m_uploaded };
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ParseOBJ
+//////////////////////////////////////////////////////////////////////
+
+bool MeshLoader::ParseOBJ(const char* data, const size_t size, Mesh& mesh) {
+    std::vector<FileChunk> chunks;
+    if (!split_obj(data, size, chunks))
+        return false;
+    std::vector<ChunkResult> results(chunks.size());
+    for (size_t x = 0; x < chunks.size(); ++x)
+        if (!parse_obj_chunk(chunks[x], results[x]))
+            return false;
+    return merge_chunks(results, mesh);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ParsePLY
+//////////////////////////////////////////////////////////////////////
+
+bool MeshLoader::ParsePLY(const char* data, const size_t size, Mesh& mesh) {
+    PlyHeader header;
+    std::vector<FileChunk> chunks;
+    if (!parse_ply_header(data, size, header) || !split_ply(data, size, header, chunks))
+        return false;
+    std::vector<ChunkResult> results(chunks.size());
+    for (size_t x = 0; x < chunks.size(); ++x)
+        if (!parse_ply_chunk(header, chunks[x], results[x]))
+            return false;
+    return merge_chunks(results, mesh);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// schedule
+//////////////////////////////////////////////////////////////////////
+
+void MeshLoader::schedule(std::function<void()>&& task) {
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskSignal.notify_one();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// finish
+//////////////////////////////////////////////////////////////////////
+
+void MeshLoader::finish(
+    const size_t ticket, const std::string& path, const size_t generation, const bool success, Mesh&& mesh) {
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    if (generation != m_generation) {
+        ++m_cancelled;
+        return;
+    }
+    if (success)
+        ++m_parsed;
+    else
+        ++m_failed;
+    m_finished.push_back({ ticket, path, success, std::move(mesh) });
+}
+
+//////////////////////////////////////////////////////////////////////
+/// work
+//////////////////////////////////////////////////////////////////////
+
+void MeshLoader::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_taskMutex);
+            m_taskSignal.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// read_file
+//////////////////////////////////////////////////////////////////////
+
+static bool read_file(const std::string& path, std::vector<char>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    const auto size = static_cast<std::streamsize>(file.tellg());
+    if (size <= 0)
+        return false;
+    bytes.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    return static_cast<bool>(file.read(bytes.data(), size));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// split_file
+//////////////////////////////////////////////////////////////////////
+
+static bool split_file(ParseJob& job) {
+    // Every PLY file starts with its magic number, anything else is treated as an OBJ
+    const auto* data = job.bytes.data();
+    const auto size = job.bytes.size();
+    job.ply = size >= 3U && std::memcmp(data, "ply", 3U) == 0;
+    if (job.ply)
+        return parse_ply_header(data, size, job.header) && split_ply(data, size, job.header, job.chunks);
+    return split_obj(data, size, job.chunks);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// parse_chunk
+//////////////////////////////////////////////////////////////////////
+
+static bool parse_chunk(ParseJob& job, const size_t chunk) {
+    if (job.ply)
+        return parse_ply_chunk(job.header, job.chunks[chunk], job.results[chunk]);
+    return parse_obj_chunk(job.chunks[chunk], job.results[chunk]);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// merge_chunks
+//////////////////////////////////////////////////////////////////////
+
+static bool merge_chunks(const std::vector<ChunkResult>& results, Mesh& mesh) {
+    size_t vertexCount = 0U;
+    size_t indexCount = 0U;
+    for (const auto& result : results) {
+        vertexCount += result.vertices.size();
+        indexCount += result.indices.size();
+    }
+    if (vertexCount == 0U)
+        return false;
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.vertices.reserve(vertexCount);
+    mesh.indices.reserve(indexCount);
+
+    // Relative indices resolve against the vertices of every earlier chunk
+    for (const auto& result : results) {
+        const auto first = static_cast<int64_t>(mesh.vertices.size());
+        mesh.vertices.insert(mesh.vertices.end(), result.vertices.begin(), result.vertices.end());
+        for (const auto& index : result.indices) {
+            const auto value = index.relative ? first + index.value : index.value;
+            if (value < 0 || value >= static_cast<int64_t>(vertexCount))
+                return false;
+            mesh.indices.push_back(static_cast<GLuint>(value));
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// split_obj
+//////////////////////////////////////////////////////////////////////
+
+static bool split_obj(const char* data, const size_t size, std::vector<FileChunk>& chunks) {
+    const auto* end = data + size;
+    const auto* begin = data;
+    while (begin < end) {
+        // Cut roughly every chunk's worth of bytes, just after a line break
+        const auto* cut = end - begin > ChunkBytes ? next_line(begin + ChunkBytes, end) : end;
+        chunks.push_back({ begin, cut, 0U, 0U });
+        begin = cut;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// parse_obj_chunk
+//////////////////////////////////////////////////////////////////////
+
+static bool parse_obj_chunk(const FileChunk& chunk, ChunkResult& result) {
+    std::vector<FaceIndex> polygon;
+    for (const auto* line = chunk.begin; line < chunk.end; line = next_line(line, chunk.end)) {
+        auto cursor = line;
+        skip_space(cursor, chunk.end);
+        if (chunk.end - cursor < 2 || (cursor[1] != ' ' && cursor[1] != '\t'))
+            continue;
+
+        if (cursor[0] == 'v') {
+            // Positions only, any trailing weight or color is ignored
+            cursor += 2;
+            vec3 position;
+            for (int x = 0; x < 3; ++x) {
+                skip_space(cursor, chunk.end);
+                if (cursor < chunk.end && *cursor == '+')
+                    ++cursor;
+                const auto parsed = std::from_chars(cursor, chunk.end, position[x]);
+                if (parsed.ec != std::errc())
+                    return false;
+                cursor = parsed.ptr;
+            }
+            result.vertices.push_back(position);
+        } else if (cursor[0] == 'f') {
+            // Keep each corner's position index, skipping any texture coordinate or normal index
+            cursor += 2;
+            polygon.clear();
+            while (true) {
+                skip_space(cursor, chunk.end);
+                if (cursor >= chunk.end || *cursor == '\n' || *cursor == '#')
+                    break;
+                int64_t index = 0;
+                const auto parsed = std::from_chars(cursor, chunk.end, index);
+                if (parsed.ec != std::errc() || index == 0)
+                    return false;
+                if (index > 0)
+                    polygon.push_back({ index - 1, false });
+                else
+                    polygon.push_back({ static_cast<int64_t>(result.vertices.size()) + index, true });
+                cursor = parsed.ptr;
+                while (cursor < chunk.end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+                    ++cursor;
+            }
+            if (polygon.size() < 3U)
+                return false;
+            fan_triangulate(polygon, result.indices);
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// parse_ply_header
+//////////////////////////////////////////////////////////////////////
+
+static bool parse_ply_header(const char* data, const size_t size, PlyHeader& header) {
+    const auto* end = data + size;
+    bool first = true;
+    for (const auto* line = data; line < end; line = next_line(line, end)) {
+        // Split the line into whitespace-separated words
+        std::vector<std::string> words;
+        for (auto cursor = line; cursor < end && *cursor != '\n';) {
+            skip_space(cursor, end);
+            const auto* word = cursor;
+            while (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+                ++cursor;
+            if (cursor != word)
+                words.emplace_back(word, cursor);
+        }
+        if (first) {
+            if (words.size() != 1U || words[0] != "ply")
+                return false;
+            first = false;
+        } else if (words.empty() || words[0] == "comment" || words[0] == "obj_info") {
+            continue;
+        } else if (words[0] == "format" && words.size() >= 2U) {
+            if (words[1] == "ascii")
+                header.format = PlyFormat::Ascii;
+            else if (words[1] == "binary_little_endian")
+                header.format = PlyFormat::BinaryLittleEndian;
+            else if (words[1] == "binary_big_endian")
+                header.format = PlyFormat::BinaryBigEndian;
+            else
+                return false;
+        } else if (words[0] == "element" && words.size() == 3U) {
+            PlyElement element;
+            element.name = words[1];
+            const auto parsed =
+                std::from_chars(words[2].data(), words[2].data() + words[2].size(), element.rows);
+            if (parsed.ec != std::errc())
+                return false;
+            header.elements.push_back(std::move(element));
+        } else if (words[0] == "property" && !header.elements.empty()) {
+            PlyProperty property;
+            if (words.size() == 5U && words[1] == "list") {
+                property.count = ply_type(words[2]);
+                property.type = ply_type(words[3]);
+                property.name = words[4];
+                if (property.count == PlyType::Invalid)
+                    return false;
+            } else if (words.size() == 3U) {
+                property.type = ply_type(words[1]);
+                property.name = words[2];
+            }
+            if (property.type == PlyType::Invalid)
+                return false;
+            header.elements.back().properties.push_back(std::move(property));
+        } else if (words[0] == "end_header") {
+            header.body = static_cast<size_t>(next_line(line, end) - data);
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// split_ply
+//////////////////////////////////////////////////////////////////////
+
+static bool split_ply(const char* data, const size_t size, const PlyHeader& header, std::vector<FileChunk>& chunks) {
+    // Rows are variable-length, so walk them once to find where each chunk starts
+    const auto* end = data + size;
+    const auto* cursor = data + header.body;
+    for (size_t e = 0; e < header.elements.size(); ++e) {
+        const auto& element = header.elements[e];
+        const auto keep = element.name == "vertex" || element.name == "face";
+        FileChunk chunk{ cursor, cursor, e, 0U };
+        for (size_t row = 0; row < element.rows; ++row) {
+            if (!skip_ply_row(header.format, element, cursor, end))
+                return false;
+            ++chunk.rows;
+            if (keep && (cursor - chunk.begin >= ChunkBytes || row + 1U == element.rows)) {
+                chunk.end = cursor;
+                chunks.push_back(chunk);
+                chunk = { cursor, cursor, e, 0U };
+            }
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// parse_ply_chunk
+//////////////////////////////////////////////////////////////////////
+
+static bool parse_ply_chunk(const PlyHeader& header, const FileChunk& chunk, ChunkResult& result) {
+    const auto& element = header.elements[chunk.element];
+    const auto isVertex = element.name == "vertex";
+    if (isVertex)
+        result.vertices.reserve(chunk.rows);
+    std::vector<FaceIndex> polygon;
+    auto cursor = chunk.begin;
+    for (size_t row = 0; row < chunk.rows; ++row) {
+        vec3 position;
+        int found = 0;
+        polygon.clear();
+        for (const auto& property : element.properties) {
+            double value = 0.0;
+            if (property.count == PlyType::Invalid) {
+                if (!read_ply_value(header.format, property.type, cursor, chunk.end, value))
+                    return false;
+                const auto axis = property.name.size() == 1U ? property.name[0] - 'x' : -1;
+                if (isVertex && axis >= 0 && axis < 3) {
+                    position[axis] = static_cast<float>(value);
+                    found |= 1 << axis;
+                }
+                continue;
+            }
+
+            // Only a face's vertex indices matter, any other list is read past
+            if (!read_ply_value(header.format, property.count, cursor, chunk.end, value) || value < 0.0)
+                return false;
+            const auto keep = !isVertex && (property.name == "vertex_indices" || property.name == "vertex_index");
+            const auto count = static_cast<size_t>(value);
+            for (size_t x = 0; x < count; ++x) {
+                if (!read_ply_value(header.format, property.type, cursor, chunk.end, value))
+                    return false;
+                if (keep)
+                    polygon.push_back({ static_cast<int64_t>(value), false });
+            }
+        }
+        if (header.format == PlyFormat::Ascii)
+            cursor = next_line(cursor, chunk.end);
+
+        if (isVertex) {
+            if (found != 7)
+                return false;
+            result.vertices.push_back(position);
+        } else if (polygon.size() >= 3U) {
+            fan_triangulate(polygon, result.indices);
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// skip_ply_row
+//////////////////////////////////////////////////////////////////////
+
+static bool skip_ply_row(const PlyFormat format, const PlyElement& element, const char*& cursor, const char* end) {
+    if (cursor >= end)
+        return false;
+    if (format == PlyFormat::Ascii) {
+        cursor = next_line(cursor, end);
+        return true;
+    }
+    for (const auto& property : element.properties) {
+        size_t count = 1U;
+        if (property.count != PlyType::Invalid) {
+            double value = 0.0;
+            if (!read_ply_value(format, property.count, cursor, end, value) || value < 0.0)
+                return false;
+            count = static_cast<size_t>(value);
+        }
+        const auto bytes = count * ply_type_size(property.type);
+        if (static_cast<size_t>(end - cursor) < bytes)
+            return false;
+        cursor += bytes;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// read_ply_value
+//////////////////////////////////////////////////////////////////////
+
+static bool read_ply_value(
+    const PlyFormat format, const PlyType type, const char*& cursor, const char* end, double& value) {
+    if (format == PlyFormat::Ascii) {
+        skip_space(cursor, end);
+        if (cursor < end && *cursor == '+')
+            ++cursor;
+        const auto parsed = std::from_chars(cursor, end, value);
+        cursor = parsed.ptr;
+        return parsed.ec == std::errc();
+    }
+
+    // Binary values are copied out, swapping byte order if the file's differs from little-endian
+    const auto size = ply_type_size(type);
+    if (static_cast<size_t>(end - cursor) < size)
+        return false;
+    unsigned char bytes[8];
+    std::memcpy(bytes, cursor, size);
+    if (format == PlyFormat::BinaryBigEndian)
+        std::reverse(bytes, bytes + size);
+    cursor += size;
+    switch (type) {
+    case PlyType::Int8:
+        value = static_cast<double>(static_cast<signed char>(bytes[0]));
+        return true;
+    case PlyType::UInt8:
+        value = static_cast<double>(bytes[0]);
+        return true;
+    case PlyType::Int16: {
+        int16_t typed = 0;
+        std::memcpy(&typed, bytes, size);
+        value = static_cast<double>(typed);
+        return true;
+    }
+    case PlyType::UInt16: {
+        uint16_t typed = 0U;
+        std::memcpy(&typed, bytes, size);
+        value = static_cast<double>(typed);
+        return true;
+    }
+    case PlyType::Int32: {
+        int32_t typed = 0;
+        std::memcpy(&typed, bytes, size);
+        value = static_cast<double>(typed);
+        return true;
+    }
+    case PlyType::UInt32: {
+        uint32_t typed = 0U;
+        std::memcpy(&typed, bytes, size);
+        value = static_cast<double>(typed);
+        return true;
+    }
+    case PlyType::Float32: {
+        float typed = 0.0F;
+        std::memcpy(&typed, bytes, size);
+        value = static_cast<double>(typed);
+        return true;
+    }
+    case PlyType::Float64:
+        std::memcpy(&value, bytes, size);
+        return true;
+    default:
+        return false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ply_type
+//////////////////////////////////////////////////////////////////////
+
+static PlyType ply_type(const std::string& name) noexcept {
+    if (name == "char" || name == "int8")
+        return PlyType::Int8;
+    if (name == "uchar" || name == "uint8")
+        return PlyType::UInt8;
+    if (name == "short" || name == "int16")
+        return PlyType::Int16;
+    if (name == "ushort" || name == "uint16")
+        return PlyType::UInt16;
+    if (name == "int" || name == "int32")
+        return PlyType::Int32;
+    if (name == "uint" || name == "uint32")
+        return PlyType::UInt32;
+    if (name == "float" || name == "float32")
+        return PlyType::Float32;
+    if (name == "double" || name == "float64")
+        return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// ply_type_size
+//////////////////////////////////////////////////////////////////////
+
+static size_t ply_type_size(const PlyType type) noexcept {
+    switch (type) {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+        return 1U;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+        return 2U;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32:
+        return 4U;
+    case PlyType::Float64:
+        return 8U;
+    default:
+        return 0U;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// fan_triangulate
+//////////////////////////////////////////////////////////////////////
+
+static void fan_triangulate(const std::vector<FaceIndex>& polygon, std::vector<FaceIndex>& indices) {
+    for (size_t x = 2; x < polygon.size(); ++x) {
+        indices.push_back(polygon[0]);
+        indices.push_back(polygon[x - 1U]);
+        indices.push_back(polygon[x]);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// skip_space
+//////////////////////////////////////////////////////////////////////
+
+static void skip_space(const char*& cursor, const char* end) noexcept {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+        ++cursor;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// next_line
+//////////////////////////////////////////////////////////////////////
+
+static const char* next_line(const char* cursor, const char* end) noexcept {
+    const auto* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    return newline != nullptr ? newline + 1 : end;
+}
\ No newline at end of file
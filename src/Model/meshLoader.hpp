@@ -0,0 +1,151 @@
+#pragma once
+#ifndef MINIGFX_MESHLOADER_HPP
+#define MINIGFX_MESHLOADER_HPP
+
+#include "Model/mesh.hpp"
+#include "Model/modelGroup.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  MeshLoader
+/// \brief  Reads and parses OBJ and PLY files on a pool of worker threads.
+/// \note   Each file is split into line-aligned chunks parsed in parallel, finished meshes wait for pump().
+class MeshLoader {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  How far along every requested file is.
+    struct Progress {
+        size_t requested = 0U; ///< Files requested since construction.
+        size_t parsed = 0U;    ///< Files parsed into meshes, less those that then failed to upload.
+        size_t failed = 0U;    ///< Files that couldn't be read, parsed or uploaded.
+        size_t cancelled = 0U; ///< Files dropped by cancel().
+        size_t uploaded = 0U;  ///< Parsed meshes a ModelGroup took in pump().
+
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Retrieve the fraction of requested files no longer being worked on.
+        /// \return 1 once every file was parsed, failed or cancelled.
+        float fraction() const noexcept {
+            return requested == 0U ? 1.0F : static_cast<float>(parsed + failed + cancelled) / requested;
+        }
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Check whether every requested file is done with, and every parsed mesh uploaded.
+        /// \return true if there is nothing left to parse or pump.
+        bool complete() const noexcept { return uploaded + failed + cancelled == requested; }
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  The outcome of a single load, as reported by pump().
+    struct Result {
+        size_t ticket = 0U;           ///< The ticket load() returned for this file.
+        std::string path;             ///< The file's path.
+        bool success = false;         ///< Whether the file was parsed and uploaded.
+        ModelGroup::GroupEntry entry; ///< Where the mesh was uploaded, empty on failure.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Cancel outstanding loads and join every worker.
+    ~MeshLoader();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Start the worker threads.
+    /// \param  threadCount the number of workers, 0 to leave one hardware thread for rendering.
+    explicit MeshLoader(const size_t threadCount = 0U);
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Queue a file for loading, parsed as PLY if it starts with the PLY magic number, OBJ otherwise.
+    /// \param  path        the file to load.
+    /// \return ticket identifying this load in the results of pump().
+    size_t load(const std::string& path);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Upload meshes that finished parsing into a group, with a single upload for all of them.
+    /// \note   Call on the thread owning the GL context. The group must hold positions only.
+    /// \param  group       the group to add the meshes to.
+    /// \param  maxMeshes   the most meshes to upload during this call.
+    /// \return the outcome of every load finished since the last call, up to maxMeshes.
+    std::vector<Result> pump(ModelGroup& group, const size_t maxMeshes = static_cast<size_t>(-1));
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Abandon every load requested so far, parsed meshes not yet pumped included.
+    /// \note   Loads requested afterwards are unaffected.
+    void cancel();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how far along every requested file is.
+    /// \return the current progress.
+    Progress progress() const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Parse an OBJ file's contents on the calling thread.
+    /// \note   Polygons are fan-triangulated, texture coordinates and normals are ignored.
+    /// \param  data        the file's contents.
+    /// \param  size        the number of bytes.
+    /// \param  mesh        the parsed mesh.
+    /// \return true on success.
+    static bool ParseOBJ(const char* data, const size_t size, Mesh& mesh);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Parse a PLY file's contents on the calling thread, ascii or binary.
+    /// \note   Only vertex positions and face vertex indices are kept.
+    /// \param  data        the file's contents.
+    /// \param  size        the number of bytes.
+    /// \param  mesh        the parsed mesh.
+    /// \return true on success.
+    static bool ParsePLY(const char* data, const size_t size, Mesh& mesh);
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    MeshLoader(const MeshLoader& o) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    MeshLoader& operator=(const MeshLoader& p) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A load that finished parsing, waiting for pump().
+    struct Finished {
+        size_t ticket = 0U;   ///< The load's ticket.
+        std::string path;     ///< The file's path.
+        bool success = false; ///< Whether the file was parsed.
+        Mesh mesh;            ///< The parsed mesh.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Hand a task to the next idle worker.
+    /// \param  task        the task to run.
+    void schedule(std::function<void()>&& task);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record a load as parsed, failed or cancelled.
+    /// \param  ticket      the load's ticket.
+    /// \param  path        the file's path.
+    /// \param  generation  the cancellation generation the load was requested in.
+    /// \param  success     whether the file was parsed.
+    /// \param  mesh        the parsed mesh.
+    void finish(
+        const size_t ticket, const std::string& path, const size_t generation, const bool success, Mesh&& mesh);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Run tasks until the loader is destroyed.
+    void work();
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<std::thread> m_workers;        ///< The worker threads.
+    std::deque<std::function<void()>> m_tasks; ///< Tasks waiting for a worker.
+    std::mutex m_taskMutex;                    ///< Guards the task queue and stop flag.
+    std::condition_variable m_taskSignal;      ///< Wakes workers when tasks arrive or the loader stops.
+    bool m_stopping = false;                   ///< Whether the workers should exit.
+    std::deque<Finished> m_finished;           ///< Loads waiting for pump().
+    std::mutex m_finishedMutex;                ///< Guards the finished queue.
+    std::atomic<size_t> m_generation{ 0U };    ///< Bumped by cancel(), loads from older generations are dropped.
+    std::atomic<size_t> m_nextTicket{ 0U };    ///< Ticket of the most recent load.
+    std::atomic<size_t> m_requested{ 0U };     ///< Files requested.
+    std::atomic<size_t> m_parsed{ 0U };        ///< Files parsed.
+    std::atomic<size_t> m_failed{ 0U };        ///< Files that failed.
+    std::atomic<size_t> m_cancelled{ 0U };     ///< Files cancelled.
+    std::atomic<size_t> m_uploaded{ 0U };      ///< Meshes uploaded.
+};
+}; // namespace mini
+
+#endif // MINIGFX_MESHLOADER_HPP
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "Model/meshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::Mesh;
+using mini::MeshOptimizationReport;
+using mini::vec3;
+using mini::VertexCacheStatistics;
+constexpr int ForsythCacheSize = 32;
+constexpr float CacheDecayPower = 1.5F;
+constexpr float LastTriangleScore = 0.75F;
+constexpr float ValenceBoostScale = 2.0F;
+constexpr float ValenceBoostPower = 0.5F;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static float vertex_score(const int /*cachePosition*/, const GLuint /*remaining*/) noexcept;
+static std::vector<unsigned int> simulate_fifo_misses(const Mesh& /*mesh*/, const size_t /*cacheSize*/);
+
+//////////////////////////////////////////////////////////////////////
+/// AnalyzeVertexCache
+//////////////////////////////////////////////////////////////////////
+
+VertexCacheStatistics mini::AnalyzeVertexCache(const Mesh& mesh, const size_t cacheSize) {
+    VertexCacheStatistics statistics;
+    const auto triangleCount = mesh.indices.size() / 3U;
+    if (triangleCount == 0U)
+        return statistics;
+
+    for (const auto misses : simulate_fifo_misses(mesh, cacheSize))
+        statistics.transforms += misses;
+
+    std::vector<bool> referenced(mesh.vertices.size(), false);
+    size_t referencedCount = 0U;
+    for (const auto index : mesh.indices)
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++referencedCount;
+        }
+
+    statistics.acmr = static_cast<float>(statistics.transforms) / static_cast<float>(triangleCount);
+    statistics.atvr = static_cast<float>(statistics.transforms) / static_cast<float>(referencedCount);
+    return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// OptimizeVertexCache
+//////////////////////////////////////////////////////////////////////
+
+void mini::OptimizeVertexCache(Mesh& mesh) {
+    const auto triangleCount = mesh.indices.size() / 3U;
+    const auto vertexCount = mesh.vertices.size();
+    if (triangleCount == 0U)
+        return;
+
+    // Build each vertex's list of triangles, the live part of each list shrinks as triangles are emitted
+    std::vector<GLuint> remaining(vertexCount, 0U);
+    for (const auto index : mesh.indices)
+        ++remaining[index];
+    std::vector<size_t> adjacencyOffset(vertexCount + 1U, 0U);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffset[v + 1U] = adjacencyOffset[v] + remaining[v];
+    std::vector<GLuint> adjacency(mesh.indices.size());
+    {
+        std::vector<size_t> cursor(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t x = 0; x < mesh.indices.size(); ++x)
+            adjacency[cursor[mesh.indices[x]]++] = static_cast<GLuint>(x / 3U);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        score[v] = vertex_score(-1, remaining[v]);
+    std::vector<bool> emitted(triangleCount, false);
+    const auto triangle_score = [&](const size_t t) {
+        return score[mesh.indices[t * 3U]] + score[mesh.indices[t * 3U + 1U]] + score[mesh.indices[t * 3U + 2U]];
+    };
+
+    // Start from the best scoring triangle overall
+    size_t best = 0U;
+    for (size_t t = 1; t < triangleCount; ++t)
+        if (triangle_score(t) > triangle_score(best))
+            best = t;
+
+    std::vector<GLuint> output;
+    output.reserve(mesh.indices.size());
+    std::vector<GLuint> cache;
+    std::vector<GLuint> nextCache;
+    cache.reserve(ForsythCacheSize + 3);
+    nextCache.reserve(ForsythCacheSize + 3);
+    size_t scanCursor = 0U;
+    constexpr auto NoTriangle = SIZE_MAX;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        // Dead end, continue from the first triangle not yet emitted
+        if (best == NoTriangle) {
+            while (emitted[scanCursor])
+                ++scanCursor;
+            best = scanCursor;
+        }
+
+        emitted[best] = true;
+        nextCache.clear();
+        for (size_t corner = 0; corner < 3U; ++corner) {
+            const auto v = mesh.indices[best * 3U + corner];
+            output.push_back(v);
+            nextCache.push_back(v);
+
+            // Swap the triangle out of the live part of the vertex's list
+            const auto first = adjacency.begin() + static_cast<std::ptrdiff_t>(adjacencyOffset[v]);
+            const auto last = first + remaining[v];
+            std::iter_swap(std::find(first, last, static_cast<GLuint>(best)), last - 1);
+            --remaining[v];
+        }
+
+        // The emitted triangle's vertices move to the front, the rest shift back
+        for (const auto v : cache)
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+                nextCache.push_back(v);
+        for (size_t x = ForsythCacheSize; x < nextCache.size(); ++x) {
+            cachePosition[nextCache[x]] = -1;
+            score[nextCache[x]] = vertex_score(-1, remaining[nextCache[x]]);
+        }
+        nextCache.resize(std::min<size_t>(nextCache.size(), ForsythCacheSize));
+        for (size_t x = 0; x < nextCache.size(); ++x) {
+            cachePosition[nextCache[x]] = static_cast<int>(x);
+            score[nextCache[x]] = vertex_score(static_cast<int>(x), remaining[nextCache[x]]);
+        }
+        std::swap(cache, nextCache);
+
+        // Only triangles touching the cache changed score, pick the best of them
+        best = NoTriangle;
+        float bestScore = -1.0F;
+        for (const auto v : cache) {
+            const auto first = adjacencyOffset[v];
+            for (size_t x = first; x < first + remaining[v]; ++x) {
+                const auto candidate = triangle_score(adjacency[x]);
+                if (candidate > bestScore) {
+                    bestScore = candidate;
+                    best = adjacency[x];
+                }
+            }
+        }
+    }
+    mesh.indices = std::move(output);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// OptimizeOverdraw
+//////////////////////////////////////////////////////////////////////
+
+void mini::OptimizeOverdraw(Mesh& mesh, const float threshold, const size_t cacheSize) {
+    const auto triangleCount = mesh.indices.size() / 3U;
+    if (triangleCount == 0U)
+        return;
+
+    // Split at cache flushes, or where a near-flush follows a cluster already cheaper than the threshold
+    const auto misses = simulate_fifo_misses(mesh, cacheSize);
+    size_t totalMisses = 0U;
+    for (const auto miss : misses)
+        totalMisses += miss;
+    const auto targetAcmr = threshold * static_cast<float>(totalMisses) / static_cast<float>(triangleCount);
+    std::vector<size_t> clusterStart{ 0U };
+    size_t clusterMisses = 0U;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const auto clusterTriangles = t - clusterStart.back();
+        const auto clusterAcmr =
+            clusterTriangles == 0U ? 3.0F : static_cast<float>(clusterMisses) / static_cast<float>(clusterTriangles);
+        if (clusterTriangles != 0U && (misses[t] == 3U || (misses[t] >= 2U && clusterAcmr <= targetAcmr))) {
+            clusterStart.push_back(t);
+            clusterMisses = 0U;
+        }
+        clusterMisses += misses[t];
+    }
+    clusterStart.push_back(triangleCount);
+
+    // Face each cluster by its area weighted normal, and place it by its area weighted centroid
+    const auto clusterCount = clusterStart.size() - 1U;
+    std::vector<vec3> clusterCentroid(clusterCount, vec3(0.0F));
+    std::vector<vec3> clusterNormal(clusterCount, vec3(0.0F));
+    vec3 meshCentroid(0.0F);
+    float meshArea = 0.0F;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float clusterArea = 0.0F;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1U]; ++t) {
+            const auto& a = mesh.vertices[mesh.indices[t * 3U]];
+            const auto& b = mesh.vertices[mesh.indices[t * 3U + 1U]];
+            const auto& d = mesh.vertices[mesh.indices[t * 3U + 2U]];
+            const auto normal = (b - a).cross(d - a);
+            const auto area = normal.length();
+            clusterNormal[c] += normal;
+            clusterCentroid[c] += (a + b + d) * (area / 3.0F);
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroid[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0F)
+            clusterCentroid[c] = clusterCentroid[c] / clusterArea;
+    }
+    if (meshArea > 0.0F)
+        meshCentroid = meshCentroid / meshArea;
+
+    // Clusters facing away from the centre occlude the rest, so draw them first
+    std::vector<float> sortKey(clusterCount, 0.0F);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const auto normalLength = clusterNormal[c].length();
+        if (normalLength > 0.0F)
+            sortKey[c] = (clusterCentroid[c] - meshCentroid).dot(clusterNormal[c] / normalLength);
+    }
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+        order[c] = c;
+    std::stable_sort(
+        order.begin(), order.end(), [&](const size_t a, const size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<GLuint> output;
+    output.reserve(mesh.indices.size());
+    for (const auto c : order)
+        output.insert(
+            output.end(), mesh.indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c] * 3U),
+            mesh.indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c + 1U] * 3U));
+    mesh.indices = std::move(output);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// OptimizeVertexFetch
+//////////////////////////////////////////////////////////////////////
+
+void mini::OptimizeVertexFetch(Mesh& mesh) {
+    constexpr auto Unassigned = UINT32_MAX;
+    std::vector<GLuint> remap(mesh.vertices.size(), Unassigned);
+    std::vector<vec3> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (auto& index : mesh.indices) {
+        if (remap[index] == Unassigned) {
+            remap[index] = static_cast<GLuint>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+        if (remap[v] == Unassigned)
+            vertices.push_back(mesh.vertices[v]);
+    mesh.vertices = std::move(vertices);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// OptimizeMesh
+//////////////////////////////////////////////////////////////////////
+
+MeshOptimizationReport mini::OptimizeMesh(Mesh& mesh, const size_t cacheSize) {
+    MeshOptimizationReport report;
+    report.before = AnalyzeVertexCache(mesh, cacheSize);
+    OptimizeVertexCache(mesh);
+    OptimizeOverdraw(mesh, 1.05F, cacheSize);
+    OptimizeVertexFetch(mesh);
+    report.after = AnalyzeVertexCache(mesh, cacheSize);
+    return report;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// vertex_score
+//////////////////////////////////////////////////////////////////////
+
+static float vertex_score(const int cachePosition, const GLuint remaining) noexcept {
+    // Vertices without any triangles left are worthless
+    if (remaining == 0U)
+        return -1.0F;
+
+    float score = 0.0F;
+    if (cachePosition >= 0) {
+        // The last triangle's vertices get a fixed score, so the next triangle doesn't just reuse its edge
+        if (cachePosition < 3)
+            score = LastTriangleScore;
+        else {
+            const auto scaler = 1.0F / static_cast<float>(ForsythCacheSize - 3);
+            score = std::pow(1.0F - (static_cast<float>(cachePosition - 3) * scaler), CacheDecayPower);
+        }
+    }
+
+    // Favour vertices with few triangles left, so they're finished off rather than stranded
+    return score + (ValenceBoostScale * std::pow(static_cast<float>(remaining), -ValenceBoostPower));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// simulate_fifo_misses
+//////////////////////////////////////////////////////////////////////
+
+static std::vector<unsigned int> simulate_fifo_misses(const Mesh& mesh, const size_t cacheSize) {
+    // A vertex is cached if fewer than cacheSize misses happened since it was last transformed
+    const auto triangleCount = mesh.indices.size() / 3U;
+    std::vector<unsigned int> misses(triangleCount, 0U);
+    std::vector<size_t> timestamp(mesh.vertices.size(), 0U);
+    size_t time = cacheSize + 1U;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (size_t corner = 0; corner < 3U; ++corner) {
+            const auto v = mesh.indices[t * 3U + corner];
+            if (time - timestamp[v] > cacheSize) {
+                timestamp[v] = time++;
+                ++misses[t];
+            }
+        }
+    }
+    return misses;
+}
\ No newline at end of file
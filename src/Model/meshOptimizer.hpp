@@ -0,0 +1,54 @@
+#pragma once
+#ifndef MINIGFX_MESHOPTIMIZER_HPP
+#define MINIGFX_MESHOPTIMIZER_HPP
+
+#include "Model/mesh.hpp"
+#include <stddef.h>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  Post-transform vertex cache efficiency of an index order.
+struct VertexCacheStatistics {
+    size_t transforms = 0U; ///< Number of vertex shader invocations a FIFO cache would incur.
+    float acmr = 0.0F;      ///< Average cache miss ratio, transforms per triangle, 0.5 at best, 3 at worst.
+    float atvr = 0.0F;      ///< Average transform to vertex ratio, transforms per referenced vertex, 1 at best.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The effect of a full optimization pass on a mesh.
+struct MeshOptimizationReport {
+    VertexCacheStatistics before; ///< Cache efficiency of the original order.
+    VertexCacheStatistics after;  ///< Cache efficiency of the optimized order.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Simulate a FIFO post-transform vertex cache over a mesh's triangles.
+/// \param  mesh        an indexed triangle mesh.
+/// \param  cacheSize   number of entries in the simulated cache.
+/// \return the mesh's cache efficiency.
+VertexCacheStatistics AnalyzeVertexCache(const Mesh& mesh, const size_t cacheSize = 16U);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Reorder triangles for post-transform vertex cache reuse, using Forsyth's scoring.
+/// \param  mesh        an indexed triangle mesh, reordered in place.
+void OptimizeVertexCache(Mesh& mesh);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Reorder cache-optimized triangles to reduce overdraw, keeping most of the cache win.
+/// \note   Splits the order into clusters at cache flushes, then draws outward-facing clusters first.
+/// \param  mesh        an indexed, cache-optimized triangle mesh, reordered in place.
+/// \param  threshold   how much worse than the mesh's ACMR a cluster may be before it's split.
+/// \param  cacheSize   number of entries in the simulated cache.
+void OptimizeOverdraw(Mesh& mesh, const float threshold = 1.05F, const size_t cacheSize = 16U);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Reorder vertices into the order the indices first reference them, for fetch locality.
+/// \note   Unreferenced vertices are kept, after every referenced one.
+/// \param  mesh        an indexed triangle mesh, reordered in place.
+void OptimizeVertexFetch(Mesh& mesh);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Run every optimization pass in order, vertex cache, overdraw, then vertex fetch.
+/// \param  mesh        an indexed triangle mesh, reordered in place.
+/// \param  cacheSize   number of entries in the simulated cache used for reporting and clustering.
+/// \return the cache efficiency before and after.
+MeshOptimizationReport OptimizeMesh(Mesh& mesh, const size_t cacheSize = 16U);
+}; // namespace mini
+
+#endif // MINIGFX_MESHOPTIMIZER_HPP
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "Model/meshSimplifier.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::LodChain;
+using mini::LodLevel;
+using mini::Mesh;
+using mini::vec3;
+constexpr double BorderWeight = 10.0;
+constexpr float MinLodShrink = 0.9F;
+constexpr size_t MinLodTriangles = 8U;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A symmetric 4x4 matrix summing squared distances to a set of weighted planes.
+struct Quadric {
+    double xx = 0.0, xy = 0.0, xz = 0.0, xw = 0.0; ///< First row.
+    double yy = 0.0, yz = 0.0, yw = 0.0;           ///< Second row, from the diagonal.
+    double zz = 0.0, zw = 0.0;                     ///< Third row, from the diagonal.
+    double ww = 0.0;                               ///< Fourth row, from the diagonal.
+    double weight = 0.0;                           ///< Sum of the plane weights.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  What a vertex may be collapsed into.
+enum class VertexKind : unsigned char {
+    Interior, ///< Surrounded by triangles, may collapse into any neighbor.
+    Border,   ///< On an open edge, may only collapse along it.
+    Locked,   ///< A corner, non-manifold or shares its position, never collapses.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The triangles around each vertex.
+struct Adjacency {
+    std::vector<size_t> offsets;   ///< Where each vertex's triangles start, plus one past the last.
+    std::vector<size_t> triangles; ///< Every vertex's triangles, back to back.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Merging one vertex into another.
+struct Collapse {
+    GLuint from = 0U;   ///< The vertex removed.
+    GLuint to = 0U;     ///< The vertex kept.
+    double error = 0.0; ///< Squared distance the collapse deviates from the original surface.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static void add_plane(Quadric& /*quadric*/, const vec3& /*normal*/, const vec3& /*point*/, const double /*weight*/);
+static void add_quadric(Quadric& /*quadric*/, const Quadric& /*other*/) noexcept;
+static double quadric_error(const Quadric& /*quadric*/, const vec3& /*point*/) noexcept;
+static Adjacency build_adjacency(const std::vector<GLuint>& /*indices*/, const size_t /*vertexCount*/);
+static bool has_edge(
+    const Adjacency& /*adjacency*/, const std::vector<GLuint>& /*indices*/, const GLuint /*from*/,
+    const GLuint /*to*/) noexcept;
+static bool collapse_flips(
+    const Adjacency& /*adjacency*/, const std::vector<GLuint>& /*indices*/, const std::vector<vec3>& /*vertices*/,
+    const Collapse& /*collapse*/) noexcept;
+static LodLevel simplify(
+    const std::vector<vec3>& /*vertices*/, const std::vector<GLuint>& /*indices*/, const size_t /*targetIndexCount*/,
+    const float /*maxError*/);
+
+//////////////////////////////////////////////////////////////////////
+/// SimplifyMesh
+//////////////////////////////////////////////////////////////////////
+
+LodLevel mini::SimplifyMesh(const Mesh& mesh, const size_t targetIndexCount, const float maxError) {
+    return simplify(mesh.vertices, mesh.indices, targetIndexCount, maxError);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// BuildLodChain
+//////////////////////////////////////////////////////////////////////
+
+LodChain mini::BuildLodChain(const Mesh& mesh, const size_t maxLevels, const float reduction) {
+    LodChain chain;
+    if (mesh.indexed()) {
+        chain.vertices = mesh.vertices;
+        chain.levels.push_back({ mesh.indices, 0.0F });
+    } else {
+        auto welded = mini::weldVertices(mesh.vertices);
+        chain.vertices = std::move(welded.vertices);
+        chain.levels.push_back({ std::move(welded.indices), 0.0F });
+    }
+
+    // Bound the vertices by their box's center, every level shares them
+    if (!chain.vertices.empty()) {
+        auto minimum = chain.vertices[0];
+        auto maximum = chain.vertices[0];
+        for (const auto& vertex : chain.vertices)
+            for (size_t axis = 0U; axis < 3U; ++axis) {
+                minimum[axis] = std::min(minimum[axis], vertex[axis]);
+                maximum[axis] = std::max(maximum[axis], vertex[axis]);
+            }
+        chain.center = (minimum + maximum) * 0.5F;
+        for (const auto& vertex : chain.vertices)
+            chain.radius = std::max(chain.radius, vec3::distance(vertex, chain.center));
+    }
+
+    // Errors add up, as each level is only measured against the one it was simplified from
+    while (chain.levels.size() < maxLevels) {
+        const auto& previous = chain.levels.back();
+        const auto targetTriangles = static_cast<size_t>(static_cast<float>(previous.indices.size() / 3U) * reduction);
+        if (targetTriangles < MinLodTriangles)
+            break;
+        auto level = simplify(chain.vertices, previous.indices, targetTriangles * 3U, 1e30F);
+        if (static_cast<float>(level.indices.size()) > static_cast<float>(previous.indices.size()) * MinLodShrink)
+            break;
+        level.error += previous.error;
+        chain.levels.push_back(std::move(level));
+    }
+    return chain;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// BuildLodChains
+//////////////////////////////////////////////////////////////////////
+
+std::vector<LodChain> mini::BuildLodChains(
+    const std::vector<Mesh>& meshes, const size_t maxLevels, const float reduction, const size_t threadCount) {
+    std::vector<LodChain> chains(meshes.size());
+    std::atomic<size_t> next{ 0U };
+    const auto work = [&]() {
+        for (auto index = next++; index < meshes.size(); index = next++)
+            chains[index] = BuildLodChain(meshes[index], maxLevels, reduction);
+    };
+
+    // The calling thread takes part, so only spawn the remaining workers
+    const auto hardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1U);
+    const auto workerCount = std::min(threadCount != 0U ? threadCount : hardwareThreads, meshes.size());
+    std::vector<std::thread> workers;
+    for (size_t x = 1U; x < workerCount; ++x)
+        workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+        worker.join();
+    return chains;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// add_plane
+//////////////////////////////////////////////////////////////////////
+
+static void add_plane(Quadric& quadric, const vec3& normal, const vec3& point, const double weight) {
+    const double a = normal.x();
+    const double b = normal.y();
+    const double c = normal.z();
+    const double d = -static_cast<double>(normal.dot(point));
+    quadric.xx += weight * a * a;
+    quadric.xy += weight * a * b;
+    quadric.xz += weight * a * c;
+    quadric.xw += weight * a * d;
+    quadric.yy += weight * b * b;
+    quadric.yz += weight * b * c;
+    quadric.yw += weight * b * d;
+    quadric.zz += weight * c * c;
+    quadric.zw += weight * c * d;
+    quadric.ww += weight * d * d;
+    quadric.weight += weight;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// add_quadric
+//////////////////////////////////////////////////////////////////////
+
+static void add_quadric(Quadric& quadric, const Quadric& other) noexcept {
+    quadric.xx += other.xx;
+    quadric.xy += other.xy;
+    quadric.xz += other.xz;
+    quadric.xw += other.xw;
+    quadric.yy += other.yy;
+    quadric.yz += other.yz;
+    quadric.yw += other.yw;
+    quadric.zz += other.zz;
+    quadric.zw += other.zw;
+    quadric.ww += other.ww;
+    quadric.weight += other.weight;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// quadric_error
+//////////////////////////////////////////////////////////////////////
+
+static double quadric_error(const Quadric& quadric, const vec3& point) noexcept {
+    const double x = point.x();
+    const double y = point.y();
+    const double z = point.z();
+    const auto error = quadric.xx * x * x + quadric.yy * y * y + quadric.zz * z * z + quadric.ww
+                       + 2.0 * (quadric.xy * x * y + quadric.xz * x * z + quadric.yz * y * z)
+                       + 2.0 * (quadric.xw * x + quadric.yw * y + quadric.zw * z);
+    return std::max(error, 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// build_adjacency
+//////////////////////////////////////////////////////////////////////
+
+static Adjacency build_adjacency(const std::vector<GLuint>& indices, const size_t vertexCount) {
+    Adjacency adjacency;
+    adjacency.offsets.assign(vertexCount + 1U, 0U);
+    for (const auto index : indices)
+        ++adjacency.offsets[index + 1U];
+    for (size_t v = 0U; v < vertexCount; ++v)
+        adjacency.offsets[v + 1U] += adjacency.offsets[v];
+
+    auto cursor = adjacency.offsets;
+    adjacency.triangles.resize(indices.size());
+    for (size_t i = 0U; i < indices.size(); ++i)
+        adjacency.triangles[cursor[indices[i]]++] = i / 3U;
+    return adjacency;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// has_edge
+//////////////////////////////////////////////////////////////////////
+
+static bool has_edge(
+    const Adjacency& adjacency, const std::vector<GLuint>& indices, const GLuint from, const GLuint to) noexcept {
+    for (auto t = adjacency.offsets[from]; t < adjacency.offsets[from + 1U]; ++t) {
+        const auto* corners = &indices[adjacency.triangles[t] * 3U];
+        for (size_t c = 0U; c < 3U; ++c)
+            if (corners[c] == from && corners[(c + 1U) % 3U] == to)
+                return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// collapse_flips
+//////////////////////////////////////////////////////////////////////
+
+static bool collapse_flips(
+    const Adjacency& adjacency, const std::vector<GLuint>& indices, const std::vector<vec3>& vertices,
+    const Collapse& collapse) noexcept {
+    // Triangles around the removed vertex that survive must keep facing the same way
+    for (auto t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1U]; ++t) {
+        const auto* corners = &indices[adjacency.triangles[t] * 3U];
+        if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+            continue;
+        vec3 before[3];
+        vec3 after[3];
+        for (size_t c = 0U; c < 3U; ++c) {
+            before[c] = vertices[corners[c]];
+            after[c] = corners[c] == collapse.from ? vertices[collapse.to] : before[c];
+        }
+        const auto normalBefore = (before[1] - before[0]).cross(before[2] - before[0]);
+        const auto normalAfter = (after[1] - after[0]).cross(after[2] - after[0]);
+        if (normalBefore.dot(normalAfter) <= 0.0F)
+            return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// simplify
+//////////////////////////////////////////////////////////////////////
+
+static LodLevel simplify(
+    const std::vector<vec3>& vertices, const std::vector<GLuint>& sourceIndices, const size_t targetIndexCount,
+    const float maxError) {
+    LodLevel level;
+    const auto vertexCount = vertices.size();
+    auto& indices = level.indices;
+    indices.reserve(sourceIndices.size());
+    for (size_t i = 0U; i + 2U < sourceIndices.size(); i += 3U) {
+        const auto a = sourceIndices[i];
+        const auto b = sourceIndices[i + 1U];
+        const auto c = sourceIndices[i + 2U];
+        if (a < vertexCount && b < vertexCount && c < vertexCount && a != b && b != c && a != c)
+            indices.insert(indices.end(), { a, b, c });
+    }
+    if (indices.size() <= targetIndexCount)
+        return level;
+
+    // Classify each vertex by its open edges, vertices sharing a position belong to a seam and stay put
+    auto adjacency = build_adjacency(indices, vertexCount);
+    std::vector<VertexKind> kinds(vertexCount, VertexKind::Interior);
+    std::vector<unsigned int> borderEdges(vertexCount, 0U);
+    for (size_t i = 0U; i < indices.size(); ++i) {
+        const auto from = indices[i];
+        const auto to = indices[i - i % 3U + (i + 1U) % 3U];
+        if (!has_edge(adjacency, indices, to, from)) {
+            ++borderEdges[from];
+            ++borderEdges[to];
+        }
+    }
+    for (size_t v = 0U; v < vertexCount; ++v)
+        if (borderEdges[v] > 2U)
+            kinds[v] = VertexKind::Locked;
+        else if (borderEdges[v] != 0U)
+            kinds[v] = VertexKind::Border;
+    std::vector<GLuint> sorted(vertexCount);
+    for (size_t v = 0U; v < vertexCount; ++v)
+        sorted[v] = static_cast<GLuint>(v);
+    const auto less = [&](const GLuint a, const GLuint b) {
+        return std::lexicographical_compare(
+            vertices[a].data(), vertices[a].data() + 3, vertices[b].data(), vertices[b].data() + 3);
+    };
+    std::sort(sorted.begin(), sorted.end(), less);
+    for (size_t v = 1U; v < vertexCount; ++v)
+        if (!less(sorted[v - 1U], sorted[v])) {
+            kinds[sorted[v - 1U]] = VertexKind::Locked;
+            kinds[sorted[v]] = VertexKind::Locked;
+        }
+
+    // Sum each vertex's planes, weighted by area, with steep planes along open edges to hold the border
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0U; i < indices.size(); i += 3U) {
+        const auto& p0 = vertices[indices[i]];
+        const auto normal = (vertices[indices[i + 1U]] - p0).cross(vertices[indices[i + 2U]] - p0);
+        const auto length = normal.length();
+        if (length <= 0.0F)
+            continue;
+        const auto unitNormal = normal / length;
+        for (size_t c = 0U; c < 3U; ++c) {
+            add_plane(quadrics[indices[i + c]], unitNormal, p0, 0.5 * length);
+            const auto from = indices[i + c];
+            const auto to = indices[i + (c + 1U) % 3U];
+            if (has_edge(adjacency, indices, to, from))
+                continue;
+            const auto edge = vertices[to] - vertices[from];
+            const auto edgeLength = edge.length();
+            if (edgeLength <= 0.0F)
+                continue;
+            const auto borderNormal = edge.cross(unitNormal) / edgeLength;
+            const auto weight = BorderWeight * edgeLength * edgeLength;
+            add_plane(quadrics[from], borderNormal, vertices[from], weight);
+            add_plane(quadrics[to], borderNormal, vertices[from], weight);
+        }
+    }
+
+    // Each pass collapses the cheapest edges that don't touch one another, then rebuilds the triangles
+    const auto maxSquaredError = static_cast<double>(maxError) * static_cast<double>(maxError);
+    const auto targetTriangles = targetIndexCount / 3U;
+    std::vector<GLuint> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<Collapse> collapses;
+    double worstError = 0.0;
+    while (indices.size() / 3U > targetTriangles) {
+        const auto can_collapse = [&](const GLuint from, const GLuint to) {
+            return kinds[from] == VertexKind::Interior
+                   || (kinds[from] == VertexKind::Border && kinds[to] != VertexKind::Interior
+                       && has_edge(adjacency, indices, from, to) != has_edge(adjacency, indices, to, from));
+        };
+        const auto cost = [&](const GLuint from, const GLuint to) {
+            auto merged = quadrics[from];
+            add_quadric(merged, quadrics[to]);
+            return merged.weight > 0.0 ? quadric_error(merged, vertices[to]) / merged.weight : 0.0;
+        };
+
+        // Find each edge once, trying both directions
+        collapses.clear();
+        for (size_t i = 0U; i < indices.size(); ++i) {
+            const auto a = indices[i];
+            const auto b = indices[i - i % 3U + (i + 1U) % 3U];
+            if (a > b && has_edge(adjacency, indices, b, a))
+                continue;
+            Collapse best{ a, b, -1.0 };
+            if (can_collapse(a, b))
+                best.error = cost(a, b);
+            if (can_collapse(b, a)) {
+                const auto error = cost(b, a);
+                if (best.error < 0.0 || error < best.error)
+                    best = { b, a, error };
+            }
+            if (best.error >= 0.0 && best.error <= maxSquaredError)
+                collapses.push_back(best);
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            return a.error < b.error;
+        });
+
+        for (size_t v = 0U; v < vertexCount; ++v)
+            remap[v] = static_cast<GLuint>(v);
+        std::fill(touched.begin(), touched.end(), false);
+        auto triangleCount = indices.size() / 3U;
+        size_t collapsed = 0U;
+        for (const auto& collapse : collapses) {
+            if (triangleCount <= targetTriangles)
+                break;
+            if (touched[collapse.from] || touched[collapse.to]
+                || collapse_flips(adjacency, indices, vertices, collapse))
+                continue;
+
+            // Neighbors are frozen for the rest of the pass, as their triangles no longer match the adjacency
+            for (auto t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1U]; ++t) {
+                const auto* corners = &indices[adjacency.triangles[t] * 3U];
+                if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+                    --triangleCount;
+                for (size_t c = 0U; c < 3U; ++c)
+                    touched[corners[c]] = true;
+            }
+            remap[collapse.from] = collapse.to;
+            add_quadric(quadrics[collapse.to], quadrics[collapse.from]);
+            worstError = std::max(worstError, collapse.error);
+            ++collapsed;
+        }
+        if (collapsed == 0U)
+            break;
+
+        size_t write = 0U;
+        for (size_t i = 0U; i < indices.size(); i += 3U) {
+            const auto a = remap[indices[i]];
+            const auto b = remap[indices[i + 1U]];
+            const auto c = remap[indices[i + 2U]];
+            if (a != b && b != c && a != c) {
+                indices[write++] = a;
+                indices[write++] = b;
+                indices[write++] = c;
+            }
+        }
+        indices.resize(write);
+        adjacency = build_adjacency(indices, vertexCount);
+    }
+    level.error = static_cast<float>(std::sqrt(worstError));
+    return level;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef MINIGFX_MESHSIMPLIFIER_HPP
+#define MINIGFX_MESHSIMPLIFIER_HPP
+
+#include "Model/mesh.hpp"
+#include "Utility/vec.hpp"
+#include <glad/glad.h>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \struct LodLevel
+/// \brief  One level of detail, as triangles over vertices shared with every other level.
+struct LodLevel {
+    std::vector<GLuint> indices; ///< Indices into the shared vertices, 3 per triangle.
+    float error = 0.0F;          ///< How far, in the mesh's units, this level may deviate from the original.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \struct LodChain
+/// \brief  A mesh and its successively simplified levels of detail.
+struct LodChain {
+    std::vector<vec3> vertices;  ///< The vertices every level indexes into.
+    std::vector<LodLevel> levels; ///< The levels, finest first, the first holding the original triangles.
+    vec3 center = vec3(0.0F);    ///< Center of a sphere bounding every vertex.
+    float radius = 0.0F;         ///< Radius of a sphere bounding every vertex.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Reduce a mesh's triangle count with quadric error metric edge collapses.
+/// \note   Vertices are only ever merged into one another, never moved, so the result indexes the original
+///         vertices. Borders only collapse along themselves, and vertices sharing a position are kept.
+/// \param  mesh                an indexed triangle mesh.
+/// \param  targetIndexCount    the index count to stop at, once reached.
+/// \param  maxError            the most any collapse may deviate from the mesh, in the mesh's units.
+/// \return the simplified indices and how far they deviate from the mesh.
+LodLevel SimplifyMesh(const Mesh& mesh, const size_t targetIndexCount, const float maxError = 1e30F);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Build a chain of levels of detail, each simplified from the one before.
+/// \note   Non-indexed meshes are welded first. The chain stops early once a level can't be reduced further.
+/// \param  mesh            the mesh to simplify.
+/// \param  maxLevels       the most levels in the chain, the original included.
+/// \param  reduction       the fraction of the previous level's triangles each level aims to keep.
+/// \return the chain of levels.
+LodChain BuildLodChain(const Mesh& mesh, const size_t maxLevels = 5U, const float reduction = 0.5F);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Build the chains of many meshes at once, spread over worker threads.
+/// \param  meshes          the meshes to simplify.
+/// \param  maxLevels       the most levels in each chain, the original included.
+/// \param  reduction       the fraction of the previous level's triangles each level aims to keep.
+/// \param  threadCount     the number of threads to use, the calling thread included, 0 to use every hardware thread.
+/// \return a chain per mesh, in the same order.
+std::vector<LodChain> BuildLodChains(
+    const std::vector<Mesh>& meshes, const size_t maxLevels = 5U, const float reduction = 0.5F,
+    const size_t threadCount = 0U);
+}; // namespace mini
+
+#endif // MINIGFX_MESHSIMPLIFIER_HPP
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "Model/meshlet.hpp"
+#include <algorithm>
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glStaticBuffer;
+using mini::Mesh;
+using mini::Meshlet;
+using mini::MeshletBuffers;
+using mini::MeshletSet;
+using mini::vec3;
+constexpr unsigned char NoLocalIndex = 0xFFU;
+constexpr size_t MaxMeshletVertices = 255U;
+constexpr float MinConeSpread = 0.1F;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static void compute_bounds(Meshlet& /*meshlet*/, const MeshletSet& /*set*/, const Mesh& /*mesh*/);
+static glStaticBuffer upload_padded(const void* /*data*/, const size_t /*size*/);
+
+//////////////////////////////////////////////////////////////////////
+/// BuildMeshlets
+//////////////////////////////////////////////////////////////////////
+
+MeshletSet mini::BuildMeshlets(
+    const Mesh& mesh, const size_t maxVertices, const size_t maxTriangles, const GLuint baseVertex) {
+    MeshletSet set;
+    const auto vertexLimit = std::clamp<size_t>(maxVertices, 3U, MaxMeshletVertices);
+    const auto triangleLimit = std::max<size_t>(maxTriangles, 1U);
+    const auto vertexCount = mesh.vertices.size();
+    const auto triangleCount = mesh.elementCount() / 3U;
+    set.indices.reserve(triangleCount * 3U);
+    set.triangles.reserve(triangleCount * 3U);
+
+    // Each vertex's index within the meshlet being built, reset whenever a meshlet is closed
+    std::vector<unsigned char> local(vertexCount, NoLocalIndex);
+    Meshlet current;
+    const auto close_meshlet = [&]() {
+        if (current.triangleCount == 0U)
+            return;
+        for (size_t v = current.vertexOffset; v < set.vertices.size(); ++v)
+            local[set.vertices[v]] = NoLocalIndex;
+        compute_bounds(current, set, mesh);
+        set.meshlets.push_back(current);
+        current = Meshlet();
+        current.vertexOffset = static_cast<GLuint>(set.vertices.size());
+        current.triangleOffset = static_cast<GLuint>(set.indices.size() / 3U);
+    };
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        GLuint corners[3];
+        for (size_t c = 0; c < 3U; ++c)
+            corners[c] = mesh.indexed() ? mesh.indices[t * 3U + c] : static_cast<GLuint>(t * 3U + c);
+        if (corners[0] >= vertexCount || corners[1] >= vertexCount || corners[2] >= vertexCount)
+            continue;
+
+        const auto added = static_cast<size_t>(local[corners[0]] == NoLocalIndex)
+                           + static_cast<size_t>(local[corners[1]] == NoLocalIndex && corners[1] != corners[0])
+                           + static_cast<size_t>(
+                               local[corners[2]] == NoLocalIndex && corners[2] != corners[0]
+                               && corners[2] != corners[1]);
+        if (current.vertexCount + added > vertexLimit || current.triangleCount + 1U > triangleLimit)
+            close_meshlet();
+
+        for (const auto corner : corners) {
+            if (local[corner] == NoLocalIndex) {
+                local[corner] = static_cast<unsigned char>(current.vertexCount++);
+                set.vertices.push_back(corner);
+            }
+            set.triangles.push_back(local[corner]);
+            set.indices.push_back(corner);
+        }
+        ++current.triangleCount;
+    }
+    close_meshlet();
+
+    if (baseVertex != 0U)
+        for (auto& vertex : set.vertices)
+            vertex += baseVertex;
+    return set;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// UploadMeshlets
+//////////////////////////////////////////////////////////////////////
+
+MeshletBuffers mini::UploadMeshlets(const MeshletSet& set) {
+    MeshletBuffers buffers;
+    buffers.meshlets = upload_padded(set.meshlets.data(), set.meshlets.size() * sizeof(Meshlet));
+    buffers.vertices = upload_padded(set.vertices.data(), set.vertices.size() * sizeof(GLuint));
+    buffers.triangles = upload_padded(set.triangles.data(), set.triangles.size());
+    buffers.count = static_cast<GLsizei>(set.meshlets.size());
+    return buffers;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// compute_bounds
+//////////////////////////////////////////////////////////////////////
+
+static void compute_bounds(Meshlet& meshlet, const MeshletSet& set, const Mesh& mesh) {
+    // The vertex list isn't offset by the base vertex until every meshlet is built
+    const auto position = [&](const size_t localIndex) -> const vec3& {
+        return mesh.vertices[set.vertices[meshlet.vertexOffset + localIndex]];
+    };
+
+    // Ritter's bounding sphere, seeded by the most distant pair of axis extremes
+    size_t minimum[3] = { 0U, 0U, 0U };
+    size_t maximum[3] = { 0U, 0U, 0U };
+    for (size_t v = 1U; v < meshlet.vertexCount; ++v)
+        for (size_t axis = 0U; axis < 3U; ++axis) {
+            if (position(v)[axis] < position(minimum[axis])[axis])
+                minimum[axis] = v;
+            if (position(v)[axis] > position(maximum[axis])[axis])
+                maximum[axis] = v;
+        }
+    size_t widest = 0U;
+    for (size_t axis = 1U; axis < 3U; ++axis)
+        if (vec3::distance(position(minimum[axis]), position(maximum[axis]))
+            > vec3::distance(position(minimum[widest]), position(maximum[widest])))
+            widest = axis;
+    auto center = (position(minimum[widest]) + position(maximum[widest])) * 0.5F;
+    auto radius = vec3::distance(position(minimum[widest]), position(maximum[widest])) * 0.5F;
+    for (size_t v = 0U; v < meshlet.vertexCount; ++v) {
+        const auto distance = vec3::distance(position(v), center);
+        if (distance > radius) {
+            const auto grown = (radius + distance) * 0.5F;
+            center += (position(v) - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
+    }
+    meshlet.center = center;
+    meshlet.radius = radius;
+
+    // The cone axis is the average facing, its spread the widest angle any triangle makes with it
+    std::vector<vec3> normals(meshlet.triangleCount, vec3(0.0F));
+    auto axis = vec3(0.0F);
+    for (size_t t = 0U; t < meshlet.triangleCount; ++t) {
+        const auto* corners = &set.triangles[(meshlet.triangleOffset + t) * 3U];
+        const auto normal = (position(corners[1]) - position(corners[0]))
+                                .cross(position(corners[2]) - position(corners[0]));
+        const auto area = normal.length();
+        if (area > 0.0F) {
+            normals[t] = normal / area;
+            axis += normals[t];
+        }
+    }
+    const auto axisLength = axis.length();
+    if (axisLength <= 0.0F)
+        return;
+    axis /= axisLength;
+    auto spread = 1.0F;
+    for (const auto& normal : normals)
+        if (normal.dot(normal) > 0.0F)
+            spread = std::min(spread, normal.dot(axis));
+    if (spread <= MinConeSpread)
+        return;
+
+    // Move the apex back along the axis until every triangle's plane is in front of it
+    auto distance = 0.0F;
+    for (size_t t = 0U; t < meshlet.triangleCount; ++t)
+        if (normals[t].dot(normals[t]) > 0.0F) {
+            const auto corner = position(set.triangles[(meshlet.triangleOffset + t) * 3U]);
+            distance = std::max(distance, (center - corner).dot(normals[t]) / normals[t].dot(axis));
+        }
+    meshlet.coneApex = center - axis * distance;
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.0F - spread * spread);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// upload_padded
+//////////////////////////////////////////////////////////////////////
+
+static glStaticBuffer upload_padded(const void* data, const size_t size) {
+    // Storage buffers are read a uint at a time and can't be empty, so round the size up to a whole uint
+    const auto paddedSize = std::max<size_t>((size + 3U) & ~size_t(3U), 4U);
+    if (paddedSize == size)
+        return glStaticBuffer(static_cast<GLsizeiptr>(size), data);
+    std::vector<unsigned char> padded(paddedSize, 0U);
+    if (size != 0U)
+        std::copy_n(static_cast<const unsigned char*>(data), size, padded.data());
+    return glStaticBuffer(static_cast<GLsizeiptr>(paddedSize), padded.data());
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef MINIGFX_MESHLET_HPP
+#define MINIGFX_MESHLET_HPP
+
+#include "Buffer/glStaticBuffer.hpp"
+#include "Model/mesh.hpp"
+#include "Utility/vec.hpp"
+#include <glad/glad.h>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \struct Meshlet
+/// \brief  A cluster of triangles with the bounds needed to cull it as a whole.
+/// \note   Matches a std430 struct of: vec3 center; float radius; vec3 coneApex; float coneCutoff; vec3 coneAxis;
+///         uint vertexOffset; uint vertexCount; uint triangleOffset; uint triangleCount; uint padding.
+struct Meshlet {
+    vec3 center = vec3(0.0F);   ///< Center of the bounding sphere.
+    float radius = 0.0F;        ///< Radius of the bounding sphere.
+    vec3 coneApex = vec3(0.0F); ///< Apex of the backface cone.
+    float coneCutoff = 1.0F;    ///< Cosine threshold of the backface cone, 1 if the cluster can't be backface culled.
+    vec3 coneAxis = vec3(0.0F); ///< Average facing of the triangles.
+    GLuint vertexOffset = 0U;   ///< Index of the first vertex within the set's vertex list.
+    GLuint vertexCount = 0U;    ///< Number of unique vertices.
+    GLuint triangleOffset = 0U; ///< Index of the first triangle within the set's triangle and index lists.
+    GLuint triangleCount = 0U;  ///< Number of triangles.
+    GLuint padding = 0U;        ///< Pads the descriptor to 64 bytes.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether every triangle faces away from a viewer.
+    /// \param  cameraPosition  the viewer's position, in the mesh's space.
+    /// \return true if the whole cluster can be skipped.
+    bool backfacing(const vec3& cameraPosition) const noexcept {
+        const auto view = coneApex - cameraPosition;
+        return view.dot(coneAxis) > coneCutoff * view.length();
+    }
+};
+static_assert(sizeof(Meshlet) == 64U, "Meshlet must match its std430 layout");
+
+//////////////////////////////////////////////////////////////////////
+/// \struct MeshletSet
+/// \brief  A mesh split into meshlets, with everything needed to draw them individually.
+struct MeshletSet {
+    std::vector<Meshlet> meshlets;        ///< The cluster descriptors.
+    std::vector<GLuint> vertices;         ///< Each meshlet's vertices, as indices into the mesh's vertices.
+    std::vector<unsigned char> triangles; ///< Each meshlet's triangles, as 3 indices into its own vertices.
+    std::vector<GLuint> indices;          ///< The mesh's indices reordered meshlet by meshlet.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \struct MeshletBuffers
+/// \brief  A meshlet set uploaded for use by shaders.
+struct MeshletBuffers {
+    glStaticBuffer meshlets;  ///< The cluster descriptors.
+    glStaticBuffer vertices;  ///< The vertex list, a uint each.
+    glStaticBuffer triangles; ///< The triangle list, 4 bytes packed into each uint.
+    GLsizei count = 0;        ///< Number of meshlets.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind the descriptor, vertex and triangle buffers to consecutive storage buffer binding points.
+    /// \param  firstIndex  the binding point of the descriptors.
+    void bind(const GLuint firstIndex) const noexcept {
+        meshlets.bindBufferBase(GL_SHADER_STORAGE_BUFFER, firstIndex);
+        vertices.bindBufferBase(GL_SHADER_STORAGE_BUFFER, firstIndex + 1U);
+        triangles.bindBufferBase(GL_SHADER_STORAGE_BUFFER, firstIndex + 2U);
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Split a mesh into meshlets, computing each one's bounding sphere and backface cone.
+/// \note   Triangles are gathered in order, so run OptimizeVertexCache() first for tighter clusters. Replacing
+///         the mesh's indices with the set's before adding it to a Model or ModelGroup lets each meshlet be drawn
+///         as the index range starting at 3 * triangleOffset.
+/// \param  mesh            a triangle mesh, indexed or not.
+/// \param  maxVertices     the most vertices in a meshlet, at most 255.
+/// \param  maxTriangles    the most triangles in a meshlet.
+/// \param  baseVertex      added to the vertex list, e.g. a ModelGroup entry's offset to address the group's buffer.
+/// \return the meshlets of the mesh.
+MeshletSet BuildMeshlets(
+    const Mesh& mesh, const size_t maxVertices = 64U, const size_t maxTriangles = 124U, const GLuint baseVertex = 0U);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Upload a meshlet set into static buffers.
+/// \param  set             the meshlets to upload.
+/// \return the buffers holding the set.
+MeshletBuffers UploadMeshlets(const MeshletSet& set);
+}; // namespace mini
+
+#endif // MINIGFX_MESHLET_HPP
\ No newline at end of file
@@ -1,36 +1,246 @@
 #include "Model/model.hpp"
+#include "Model/meshCache.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
+using mini::LodChain;
+using mini::mat4;
+using mini::MemoryRegistry;
+using mini::MeshCache;
+using mini::Mesh;
 using mini::Model;
+using mini::PositionEncoding;
 using mini::vec3;
+using mini::VertexDescription;
+using mini::VertexFormat;
+using mini::VertexLayout;
+constexpr float MinLodDistance = 1e-4F;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static Mesh concatenate_levels(const LodChain& /*chain*/);
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Destructor
 //////////////////////////////////////////////////////////////////////
 
 Model::~Model() {
+    if (m_vboID != 0U)
+        MemoryRegistry::Free(MemoryRegistry::Category::Model, m_vertexBytes);
+    if (m_eboID != 0U)
+        MemoryRegistry::Free(MemoryRegistry::Category::Model, m_indexBytes);
     glDeleteBuffers(1, &m_vboID);
+    glDeleteBuffers(1, &m_eboID);
     glDeleteVertexArrays(1, &m_vaoID);
+    glDeleteVertexArrays(1, &m_positionVaoID);
 }
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Constructor
 //////////////////////////////////////////////////////////////////////
 
-Model::Model(const std::vector<vec3>& vertices) : m_vertexCount(vertices.size()) {
+Model::Model(const std::vector<vec3>& vertices)
+    : m_vertexCount(vertices.size()), m_format(VertexFormat<vec3>::Describe(VertexLayout::Interleaved)) {
+    create_vertex_buffer(vertices.data());
+}
+
+//////////////////////////////////////////////////////////////////////
+
+Model::Model(const Mesh& mesh, const PositionEncoding encoding)
+    : m_vertexCount(mesh.vertices.size()), m_positionEncoding(encoding) {
+    if (encoding == PositionEncoding::Float32) {
+        m_format = VertexFormat<vec3>::Describe(VertexLayout::Interleaved);
+        create_vertex_buffer(mesh.vertices.data());
+    } else {
+        // 4 x 16-bit per vertex keeps every vertex 4-byte aligned, the 4th component is ignored
+        const auto quantized = mini::QuantizePositions(mesh.vertices, encoding);
+        m_positionOffset = quantized.offset;
+        m_positionScale = quantized.scale;
+        m_format = encoding == PositionEncoding::Half
+                       ? VertexFormat<mini::HalfPosition>::Describe(VertexLayout::Interleaved)
+                       : VertexFormat<mini::Unorm16Position>::Describe(VertexLayout::Interleaved);
+        create_vertex_buffer(quantized.data.data());
+    }
+    create_element_buffer(mesh.indices);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+Model::Model(
+    const VertexDescription& format, const void* vertexData, const size_t vertexCount,
+    const std::vector<GLuint>& indices)
+    : m_vertexCount(vertexCount), m_format(format) {
+    create_vertex_buffer(vertexData);
+    create_element_buffer(indices);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+Model::Model(const MeshCache& cache)
+    : m_vertexCount(cache.contents().vertexCount), m_positionEncoding(cache.contents().positionEncoding),
+      m_positionOffset(cache.contents().positionOffset), m_positionScale(cache.contents().positionScale),
+      m_format(cache.contents().format) {
+    const auto& contents = cache.contents();
+    create_vertex_buffer(contents.vertexData);
+
+    // Levels of detail share the vertices and the whole index blob, each entry being a range within it
+    const auto& entries = contents.entries;
+    const auto levels = !entries.empty() && contents.lodErrors.size() == entries.size()
+                        && std::all_of(entries.cbegin(), entries.cend(), [&](const auto& entry) {
+                               return entry.offset == 0 && entry.indexCount != 0
+                                      && entry.indexType == entries[0].indexType;
+                           });
+    if (levels) {
+        m_indexType = entries[0].indexType;
+        const auto indexSize = static_cast<GLintptr>(mini::IndexTypeSize(m_indexType));
+        for (size_t x = 0; x < entries.size(); ++x)
+            m_lods.push_back(
+                { static_cast<size_t>(entries[x].indexOffset / indexSize),
+                  static_cast<size_t>(entries[x].indexCount), contents.lodErrors[x] });
+        m_indexCount = m_lods[0].indexCount;
+        m_boundsCenter = contents.boundsCenter;
+        m_boundsRadius = contents.boundsRadius;
+        create_element_buffer(contents.indexData, static_cast<GLsizeiptr>(contents.indexBytes));
+    } else if (entries.size() == 1U && entries[0].offset == 0 && entries[0].indexCount != 0) {
+        // Indices of a lone entry are relative to the first vertex, so the mapped bytes are usable as-is
+        const auto& entry = contents.entries[0];
+        m_indexCount = static_cast<size_t>(entry.indexCount);
+        m_indexType = entry.indexType;
+        create_element_buffer(
+            static_cast<const unsigned char*>(contents.indexData) + entry.indexOffset,
+            static_cast<GLsizeiptr>(m_indexCount * mini::IndexTypeSize(m_indexType)));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+
+Model::Model(const LodChain& chain, const PositionEncoding encoding)
+    : Model(concatenate_levels(chain), encoding) {
+    size_t firstIndex = 0U;
+    for (const auto& level : chain.levels) {
+        m_lods.push_back({ firstIndex, level.indices.size(), level.error });
+        firstIndex += level.indices.size();
+    }
+    if (!m_lods.empty())
+        m_indexCount = m_lods[0].indexCount;
+    m_boundsCenter = chain.center;
+    m_boundsRadius = chain.radius;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+Model& Model::operator=(Model&& p) noexcept {
+    if (&p != this) {
+        std::swap(m_vertexCount, p.m_vertexCount);
+        std::swap(m_indexCount, p.m_indexCount);
+        std::swap(m_indexType, p.m_indexType);
+        std::swap(m_vaoID, p.m_vaoID);
+        std::swap(m_positionVaoID, p.m_positionVaoID);
+        std::swap(m_vboID, p.m_vboID);
+        std::swap(m_eboID, p.m_eboID);
+        std::swap(m_vertexBytes, p.m_vertexBytes);
+        std::swap(m_indexBytes, p.m_indexBytes);
+        std::swap(m_positionEncoding, p.m_positionEncoding);
+        std::swap(m_positionOffset, p.m_positionOffset);
+        std::swap(m_positionScale, p.m_positionScale);
+        std::swap(m_format, p.m_format);
+        std::swap(m_lods, p.m_lods);
+        std::swap(m_boundsCenter, p.m_boundsCenter);
+        std::swap(m_boundsRadius, p.m_boundsRadius);
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// create_vertex_buffer
+//////////////////////////////////////////////////////////////////////
+
+void Model::create_vertex_buffer(const void* data) {
     // Create GL Objects
     glCreateVertexArrays(1, &m_vaoID);
     glCreateBuffers(1, &m_vboID);
 
     // Load geometry into vertex buffer object
-    glNamedBufferStorage(m_vboID, sizeof(vec3) * vertices.size(), &vertices[0], GL_CLIENT_STORAGE_BIT);
+    m_vertexBytes = static_cast<GLsizeiptr>(m_format.stride) * static_cast<GLsizeiptr>(m_vertexCount);
+    glNamedBufferStorage(m_vboID, m_vertexBytes, data, GL_CLIENT_STORAGE_BIT);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::Model, m_vertexBytes);
 
-    // Connect and set-up the vertex array object
-    glEnableVertexArrayAttrib(m_vaoID, 0);
-    glVertexArrayAttribBinding(m_vaoID, 0, 0);
-    glVertexArrayAttribFormat(m_vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayVertexBuffer(m_vaoID, 0, m_vboID, 0, sizeof(vec3));
+    // Connect and set-up the vertex array objects, a position-only one is only needed with other attributes
+    m_format.configure(m_vaoID, m_vboID, m_vertexCount);
+    if (m_format.attributes.size() > 1U) {
+        glCreateVertexArrays(1, &m_positionVaoID);
+        m_format.configurePositions(m_positionVaoID, m_vboID, m_vertexCount);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// create_element_buffer
+//////////////////////////////////////////////////////////////////////
+
+void Model::create_element_buffer(const std::vector<GLuint>& indices) {
+    if (indices.empty())
+        return;
+
+    // Pack indices as narrow as the vertex count allows
+    m_indexCount = indices.size();
+    m_indexType = mini::IndexTypeFor(m_vertexCount);
+    const auto packed = mini::PackIndices(indices, m_indexType);
+    create_element_buffer(packed.data(), static_cast<GLsizeiptr>(packed.size()));
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void Model::create_element_buffer(const void* data, const GLsizeiptr bytes) {
+    // Load indices into element buffer object
+    glCreateBuffers(1, &m_eboID);
+    m_indexBytes = bytes;
+    glNamedBufferStorage(m_eboID, m_indexBytes, data, GL_CLIENT_STORAGE_BIT);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::Model, m_indexBytes);
+    glVertexArrayElementBuffer(m_vaoID, m_eboID);
+    if (m_positionVaoID != 0U)
+        glVertexArrayElementBuffer(m_positionVaoID, m_eboID);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// save
+//////////////////////////////////////////////////////////////////////
+
+bool Model::save(const std::string& path) const {
+    std::vector<unsigned char> vertices(static_cast<size_t>(m_vertexBytes));
+    std::vector<unsigned char> indices(static_cast<size_t>(m_indexBytes));
+    if (!vertices.empty())
+        glGetNamedBufferSubData(m_vboID, 0, m_vertexBytes, vertices.data());
+    if (!indices.empty())
+        glGetNamedBufferSubData(m_eboID, 0, m_indexBytes, indices.data());
+
+    MeshCache::Contents contents;
+    contents.format = m_format;
+    contents.vertexCount = m_vertexCount;
+    contents.vertexData = vertices.data();
+    contents.indexData = indices.data();
+    contents.indexBytes = indices.size();
+    if (m_lods.empty())
+        contents.entries.push_back(
+            { 0, static_cast<GLsizei>(m_vertexCount), 0, static_cast<GLsizei>(m_indexCount), m_indexType });
+
+    // Each level of detail gets an entry over its range of the shared index blob
+    const auto indexSize = mini::IndexTypeSize(m_indexType);
+    for (const auto& range : m_lods) {
+        contents.entries.push_back(
+            { 0, static_cast<GLsizei>(m_vertexCount), static_cast<GLintptr>(range.firstIndex * indexSize),
+              static_cast<GLsizei>(range.indexCount), m_indexType });
+        contents.lodErrors.push_back(range.error);
+    }
+    contents.boundsCenter = m_boundsCenter;
+    contents.boundsRadius = m_boundsRadius;
+    contents.positionEncoding = m_positionEncoding;
+    contents.positionOffset = m_positionOffset;
+    contents.positionScale = m_positionScale;
+    return MeshCache::Write(path, contents);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -38,5 +248,63 @@ Model::Model(const std::vector<vec3>& vertices) : m_vertexCount(vertices.size())
 //////////////////////////////////////////////////////////////////////
 
 void Model::draw(const int drawMode) const noexcept {
-    glDrawArrays(static_cast<GLenum>(drawMode), 0, static_cast<GLsizei>(m_vertexCount));
+    if (m_indexCount != 0U)
+        glDrawElements(static_cast<GLenum>(drawMode), static_cast<GLsizei>(m_indexCount), m_indexType, nullptr);
+    else
+        glDrawArrays(static_cast<GLenum>(drawMode), 0, static_cast<GLsizei>(m_vertexCount));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// drawLod
+//////////////////////////////////////////////////////////////////////
+
+void Model::drawLod(const int drawMode, const size_t lod) const noexcept {
+    if (m_lods.empty()) {
+        draw(drawMode);
+        return;
+    }
+    const auto& range = m_lods[std::min(lod, m_lods.size() - 1U)];
+    const auto offset = range.firstIndex * mini::IndexTypeSize(m_indexType);
+    glDrawElements(
+        static_cast<GLenum>(drawMode), static_cast<GLsizei>(range.indexCount), m_indexType,
+        reinterpret_cast<const void*>(offset));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// selectLod
+//////////////////////////////////////////////////////////////////////
+
+size_t Model::selectLod(const mat4& viewProjection, const float viewportHeight, const float maxPixelError) const
+    noexcept {
+    if (m_lods.size() < 2U)
+        return 0U;
+
+    // Column-major, so row r of column c is at [c * 4 + r]
+    const auto* m = viewProjection.data();
+    const auto& c = m_boundsCenter;
+    const auto w = m[3] * c.x() + m[7] * c.y() + m[11] * c.z() + m[15];
+    const auto wScale = vec3(m[3], m[7], m[11]).length();
+    const auto yScale = vec3(m[1], m[5], m[9]).length();
+
+    // Project from the nearest point of the bounds, a viewer inside them always gets the finest level
+    const auto distance = w - m_boundsRadius * wScale;
+    if (distance <= MinLodDistance)
+        return 0U;
+    const auto pixelsPerUnit = yScale * 0.5F * viewportHeight / distance;
+    size_t lod = 0U;
+    while (lod + 1U < m_lods.size() && m_lods[lod + 1U].error * pixelsPerUnit <= maxPixelError)
+        ++lod;
+    return lod;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// concatenate_levels
+//////////////////////////////////////////////////////////////////////
+
+static Mesh concatenate_levels(const LodChain& chain) {
+    Mesh mesh;
+    mesh.vertices = chain.vertices;
+    for (const auto& level : chain.levels)
+        mesh.indices.insert(mesh.indices.end(), level.indices.begin(), level.indices.end());
+    return mesh;
 }
\ No newline at end of file
@@ -2,11 +2,20 @@
 #ifndef MINIGFX_MODEL_HPP
 #define MINIGFX_MODEL_HPP
 
+#include "Model/mesh.hpp"
+#include "Model/meshSimplifier.hpp"
+#include "Model/vertexFormat.hpp"
+#include "Model/vertexQuantization.hpp"
+#include "Utility/mat.hpp"
 #include "Utility/vec.hpp"
 #include <glad/glad.h>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace mini {
+class MeshCache;
+
 //////////////////////////////////////////////////////////////////////
 /// \class  Model
 /// \brief  A representation of an OpenGL model.
@@ -20,24 +29,129 @@ class Model {
     /// \param  vertices    the vertices to use(as triangles).
     explicit Model(const std::vector<vec3>& vertices);
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default move constructor.
-    Model(Model&& o) noexcept = default;
+    /// \brief  Construct a model given a mesh, drawing it through an element buffer if indexed.
+    /// \note   Indices are stored as 16-bit whenever the vertex count allows it.
+    /// \note   Quantized positions must be decoded in the shader using positionOffset() and positionScale().
+    /// \param  mesh        the mesh to use.
+    /// \param  encoding    how to store the positions on the GPU.
+    explicit Model(const Mesh& mesh, const PositionEncoding encoding = PositionEncoding::Float32);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a model from already packed vertex data of any format.
+    /// \param  format      the format and layout the vertex data was packed with.
+    /// \param  vertexData  the packed vertex data.
+    /// \param  vertexCount the number of vertices packed.
+    /// \param  indices     indices into the vertices, 3 per triangle, empty if not indexed.
+    Model(
+        const VertexDescription& format, const void* vertexData, const size_t vertexCount,
+        const std::vector<GLuint>& indices = {});
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a model from a mapped cache, handing its blobs straight to buffer storage.
+    /// \note   Indices are only kept when the cache holds a single entry starting at the first vertex, or the
+    ///         levels of detail of a model saved with them.
+    /// \param  cache       an open cache, usually written by save().
+    explicit Model(const MeshCache& cache);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a model holding every level of a chain, with all of their indices in one element buffer.
+    /// \note   The levels share the vertices, draw() and indexCount() refer to the finest level.
+    /// \param  chain       the levels of detail to use.
+    /// \param  encoding    how to store the positions on the GPU.
+    explicit Model(const LodChain& chain, const PositionEncoding encoding = PositionEncoding::Float32);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a model from one stream per attribute, packed as VertexFormat<Position, Attributes...>.
+    /// \param  layout      whether to interleave the attributes or keep them as separate streams.
+    /// \param  indices     indices into the vertices, 3 per triangle, empty if not indexed.
+    /// \param  positions   the position of each vertex, bound at location 0.
+    /// \param  streams     the remaining attributes of each vertex, bound at locations 1 onwards.
+    template <typename Position, typename... Attributes>
+    Model(
+        const VertexLayout layout, const std::vector<GLuint>& indices, const std::vector<Position>& positions,
+        const std::vector<Attributes>&... streams)
+        : Model(
+              VertexFormat<Position, Attributes...>::Describe(layout),
+              VertexFormat<Position, Attributes...>::Pack(layout, positions, streams...).data(), positions.size(),
+              indices) {}
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    Model(Model&& o) noexcept { (*this) = std::move(o); }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default move-assignment operator.
-    Model& operator=(Model&& p) noexcept = default;
+    /// \brief  Move-assignment operator, swapping so the other model releases this one's objects.
+    Model& operator=(Model&& p) noexcept;
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Bind this model to the current context for rendering.
     void bind() const noexcept { glBindVertexArray(m_vaoID); }
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind only this model's positions, for passes such as depth-only or shadows.
+    /// \note   With a separate layout, no other attribute stream is fetched.
+    void bindPositions() const noexcept { glBindVertexArray(m_positionVaoID != 0U ? m_positionVaoID : m_vaoID); }
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Draw this model.
     /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
     void draw(const int drawMode) const noexcept;
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Draw the coarsest level of detail whose error stays below a pixel threshold on screen.
+    /// \param  drawMode        either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+    /// \param  viewProjection  the view-projection matrix, multiplied by the model's world transform if any.
+    /// \param  viewportHeight  the height of the viewport in pixels.
+    /// \param  maxPixelError   the most a level may deviate from the original on screen, in pixels.
+    void draw(
+        const int drawMode, const mat4& viewProjection, const float viewportHeight,
+        const float maxPixelError = 1.0F) const noexcept {
+        drawLod(drawMode, selectLod(viewProjection, viewportHeight, maxPixelError));
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Draw a specific level of detail.
+    /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+    /// \param  lod         the level to draw, 0 being the finest, clamped to the coarsest.
+    void drawLod(const int drawMode, const size_t lod) const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Pick the coarsest level of detail whose projected error stays below a pixel threshold.
+    /// \note   The error is projected from the nearest point of the model's bounding sphere.
+    /// \param  viewProjection  the view-projection matrix, multiplied by the model's world transform if any.
+    /// \param  viewportHeight  the height of the viewport in pixels.
+    /// \param  maxPixelError   the most a level may deviate from the original on screen, in pixels.
+    /// \return the level to draw, 0 being the finest.
+    size_t selectLod(const mat4& viewProjection, const float viewportHeight, const float maxPixelError = 1.0F) const
+        noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of levels of detail.
+    /// \return the level count, 1 if built without a chain.
+    size_t lodCount() const noexcept { return m_lods.empty() ? 1U : m_lods.size(); }
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Retrieve this model's vertex count.
     /// \return the model's vertex count.
     size_t vertexCount() const noexcept { return m_vertexCount; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve this model's index count.
+    /// \return the model's index count, 0 if not indexed.
+    size_t indexCount() const noexcept { return m_indexCount; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the type of this model's indices.
+    /// \return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    GLenum indexType() const noexcept { return m_indexType; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how this model's positions are stored.
+    /// \return the position encoding.
+    PositionEncoding positionEncoding() const noexcept { return m_positionEncoding; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the offset added to each position attribute, zero if not quantized.
+    /// \return the position offset.
+    const vec3& positionOffset() const noexcept { return m_positionOffset; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the scale applied to each position attribute, one if not quantized.
+    /// \return the position scale.
+    const vec3& positionScale() const noexcept { return m_positionScale; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Read this model back from the GPU and write it as a cache file.
+    /// \note   Levels of detail are written as an entry each, along with the bounds used to select them.
+    /// \param  path        the file to write, replaced if it exists.
+    /// \return true on success.
+    bool save(const std::string& path) const;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the format and layout of this model's vertices.
+    /// \return the vertex description.
+    const VertexDescription& format() const noexcept { return m_format; }
 
     private:
     //////////////////////////////////////////////////////////////////////
@@ -46,12 +160,46 @@ class Model {
     //////////////////////////////////////////////////////////////////////
     /// \brief  Default copy-assignment operator.
     Model& operator=(const Model& p) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Create the vertex buffer and the VAOs reading from it.
+    /// \param  data        the packed vertex data to upload.
+    void create_vertex_buffer(const void* data);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Create the element buffer and attach it to the VAOs.
+    /// \param  indices     the indices to upload, nothing is created if empty.
+    void create_element_buffer(const std::vector<GLuint>& indices);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Create the element buffer from indices already packed as m_indexType.
+    /// \param  data        the packed indices.
+    /// \param  bytes       byte-size of the packed indices.
+    void create_element_buffer(const void* data, const GLsizeiptr bytes);
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A level of detail's range within the element buffer.
+    struct LodRange {
+        size_t firstIndex = 0U; ///< The level's first index.
+        size_t indexCount = 0U; ///< The level's number of indices.
+        float error = 0.0F;     ///< How far the level may deviate from the original, in the model's units.
+    };
 
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    size_t m_vertexCount = 0ULL; ///< The number of vertices in this model.
-    GLuint m_vaoID = 0U;         ///< The OpenGL vertex array object ID.
-    GLuint m_vboID = 0U;         ///< The OpenGL vertex buffer object ID.
+    size_t m_vertexCount = 0ULL;                                     ///< The number of vertices in this model.
+    size_t m_indexCount = 0ULL;                                      ///< The number of indices in this model.
+    GLenum m_indexType = GL_UNSIGNED_INT;                            ///< The type of each index.
+    GLuint m_vaoID = 0U;                                             ///< The OpenGL vertex array object ID.
+    GLuint m_positionVaoID = 0U;                                     ///< A VAO with only the position, 0 if unneeded.
+    GLuint m_vboID = 0U;                                             ///< The OpenGL vertex buffer object ID.
+    GLuint m_eboID = 0U;                                             ///< The OpenGL element buffer object ID.
+    GLsizeiptr m_vertexBytes = 0;                                    ///< Byte-size of the vertex buffer's storage.
+    GLsizeiptr m_indexBytes = 0;                                     ///< Byte-size of the element buffer's storage.
+    PositionEncoding m_positionEncoding = PositionEncoding::Float32; ///< How positions are stored.
+    vec3 m_positionOffset = vec3(0.0F);                              ///< Added to each position attribute.
+    vec3 m_positionScale = vec3(1.0F);                               ///< Multiplies each position attribute.
+    VertexDescription m_format;                                      ///< The format and layout of the vertices.
+    std::vector<LodRange> m_lods;                                    ///< Each level of detail, finest first.
+    vec3 m_boundsCenter = vec3(0.0F);                                ///< Center of the LOD selection sphere.
+    float m_boundsRadius = 0.0F;                                     ///< Radius of the LOD selection sphere.
 };
 }; // namespace mini
 
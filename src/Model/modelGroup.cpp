@@ -1,13 +1,48 @@
 #include "Model/modelGroup.hpp"
+#include "Buffer/glFence.hpp"
+#include "Model/meshCache.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
+using mini::glFence;
+using mini::glRingBuffer;
+using mini::glWriteMode;
+using mini::MemoryRegistry;
+using mini::MeshCache;
+using mini::Mesh;
 using mini::ModelGroup;
 using mini::vec3;
+using mini::VertexDescription;
+using mini::VertexFormat;
+using mini::VertexLayout;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A range to carry over from an old buffer into its replacement.
+struct CopyRegion {
+    GLintptr from = 0;   ///< Byte offset in the old buffer.
+    GLintptr to = 0;     ///< Byte offset in the new buffer.
+    GLsizeiptr size = 0; ///< Bytes to copy.
+};
 
 //////////////////////////////////////////////////////////////////////
 /// Forward Declarations
 static void wait_on_fence(GLsync& /*fence*/) noexcept;
+static void grow_storage(
+    GLuint& /*bufferID*/, const std::vector<CopyRegion>& /*regions*/, const GLsizeiptr /*newBytes*/,
+    GLsync& /*fence*/);
+static void draw_commands(
+    const int /*drawMode*/, const std::vector<unsigned char>& /*commands*/, const GLsizei (&/*counts*/)[3]) noexcept;
+static void move_bytes(const GLuint /*bufferID*/, GLintptr /*from*/, GLintptr /*to*/, GLsizeiptr /*size*/) noexcept;
+template <typename T>
+static bool take_range(std::map<T, T>& /*holes*/, const T /*size*/, const T /*alignment*/, T& /*offset*/);
+template <typename T, typename U>
+static void release_range(std::map<T, T>& /*holes*/, T /*offset*/, T /*size*/, U& /*used*/);
+template <typename T> static T total_size(const std::map<T, T>& /*holes*/) noexcept;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Destructor
@@ -15,8 +50,14 @@ static void wait_on_fence(GLsync& /*fence*/) noexcept;
 
 ModelGroup::~ModelGroup() {
     // Delete all objects created
+    if (m_vboID != 0U)
+        MemoryRegistry::Free(MemoryRegistry::Category::ModelGroup, m_vboBytes);
+    if (m_eboID != 0U)
+        MemoryRegistry::Free(MemoryRegistry::Category::ModelGroup, m_eboBytes);
     glDeleteBuffers(1, &m_vboID);
+    glDeleteBuffers(1, &m_eboID);
     glDeleteVertexArrays(1, &m_vaoID);
+    glDeleteVertexArrays(1, &m_positionVaoID);
     glDeleteSync(m_fence);
 }
 
@@ -24,19 +65,138 @@ ModelGroup::~ModelGroup() {
 /// Custom Constructor
 //////////////////////////////////////////////////////////////////////
 
-ModelGroup::ModelGroup(const size_t& count) : m_capacity(count) {
-    // Create GL Objects
-    glCreateVertexArrays(1, &m_vaoID);
-    glCreateBuffers(1, &m_vboID);
+ModelGroup::ModelGroup(const size_t& count)
+    : ModelGroup(VertexFormat<vec3>::Describe(VertexLayout::Interleaved), count) {}
 
-    // Load geometry into vertex buffer object
-    glNamedBufferStorage(m_vboID, sizeof(vec3) * count, nullptr, GL_DYNAMIC_STORAGE_BIT);
+//////////////////////////////////////////////////////////////////////
 
-    // Connect and set-up the vertex array object
-    glEnableVertexArrayAttrib(m_vaoID, 0);
-    glVertexArrayAttribBinding(m_vaoID, 0, 0);
-    glVertexArrayAttribFormat(m_vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayVertexBuffer(m_vaoID, 0, m_vboID, 0, sizeof(vec3));
+ModelGroup::ModelGroup(const VertexDescription& format, const size_t& count) : m_capacity(count), m_format(format) {
+    create_vertex_buffer(nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::ModelGroup(const MeshCache& cache, const size_t& count)
+    : m_size(cache.contents().vertexCount), m_capacity(std::max(count, cache.contents().vertexCount)),
+      m_format(cache.contents().format) {
+    // The vertex blob is laid out for exactly its vertex count, so only use it as-is without extra capacity
+    const auto& contents = cache.contents();
+    create_vertex_buffer(m_capacity == m_size ? contents.vertexData : nullptr);
+    const auto* source = static_cast<const unsigned char*>(contents.vertexData);
+    if (m_capacity != m_size && m_size != 0U) {
+        if (m_format.layout == VertexLayout::Separate)
+            for (size_t x = 0; x < m_format.attributes.size(); ++x)
+                glNamedBufferSubData(
+                    m_vboID, m_format.streamOffset(x, m_capacity),
+                    static_cast<GLsizeiptr>(m_format.attributes[x].size) * static_cast<GLsizeiptr>(m_size),
+                    source + m_format.streamOffset(x, m_size));
+        else
+            glNamedBufferSubData(
+                m_vboID, 0, static_cast<GLsizeiptr>(m_format.stride) * static_cast<GLsizeiptr>(m_size), source);
+    }
+
+    // The index blob always fits exactly
+    if (contents.indexBytes != 0U) {
+        m_indexSize = static_cast<GLsizeiptr>(contents.indexBytes);
+        m_eboBytes = m_indexSize;
+        glCreateBuffers(1, &m_eboID);
+        glNamedBufferStorage(m_eboID, m_eboBytes, contents.indexData, GL_DYNAMIC_STORAGE_BIT);
+        MemoryRegistry::Allocate(MemoryRegistry::Category::ModelGroup, m_eboBytes);
+        glVertexArrayElementBuffer(m_vaoID, m_eboID);
+        if (m_positionVaoID != 0U)
+            glVertexArrayElementBuffer(m_positionVaoID, m_eboID);
+    }
+    restore_entries(contents.entries);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup& ModelGroup::operator=(ModelGroup&& p) noexcept {
+    if (&p != this) {
+        std::swap(m_size, p.m_size);
+        std::swap(m_capacity, p.m_capacity);
+        std::swap(m_indexSize, p.m_indexSize);
+        std::swap(m_vaoID, p.m_vaoID);
+        std::swap(m_positionVaoID, p.m_positionVaoID);
+        std::swap(m_vboID, p.m_vboID);
+        std::swap(m_eboID, p.m_eboID);
+        std::swap(m_vboBytes, p.m_vboBytes);
+        std::swap(m_eboBytes, p.m_eboBytes);
+        std::swap(m_fence, p.m_fence);
+        std::swap(m_format, p.m_format);
+        std::swap(m_live, p.m_live);
+        std::swap(m_liveIndices, p.m_liveIndices);
+        std::swap(m_freeVertices, p.m_freeVertices);
+        std::swap(m_freeIndices, p.m_freeIndices);
+        std::swap(m_baseInstances, p.m_baseInstances);
+        std::swap(m_commands, p.m_commands);
+        std::swap(m_commandData, p.m_commandData);
+        std::swap(m_commandCounts, p.m_commandCounts);
+        std::swap(m_commandsDirty, p.m_commandsDirty);
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// draw
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::draw(const int drawMode) {
+    if (m_commandsDirty) {
+        // Rebuild the whole mirror, orphaning the old one so draws still reading it never stall us
+        std::vector<GroupEntry> entries;
+        entries.reserve(m_live.size());
+        for (const auto& live : m_live)
+            entries.push_back(live.second);
+        build_commands(entries, m_commandData, m_commandCounts);
+        if (!m_commandData.empty()) {
+            m_commands.write(
+                0, static_cast<GLsizeiptr>(m_commandData.size()), m_commandData.data(), glWriteMode::InvalidateWhole);
+            m_commands.endWriting();
+        }
+        m_commandsDirty = false;
+    }
+    if (m_commandData.empty())
+        return;
+
+    m_commands.bindBuffer(GL_DRAW_INDIRECT_BUFFER);
+    multi_draw(drawMode, 0, m_commandCounts);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::draw(const int drawMode, const std::vector<GroupEntry>& visible, glRingBuffer& ring) const {
+    std::vector<unsigned char> commands;
+    GLsizei counts[3] = {};
+    build_commands(visible, commands, counts);
+    if (commands.empty())
+        return;
+
+    // Issue the commands one by one if this frame's ring is exhausted
+    const auto range = ring.write(static_cast<GLsizeiptr>(commands.size()), commands.data());
+    if (range.pointer == nullptr) {
+        draw_commands(drawMode, commands, counts);
+        return;
+    }
+    ring.bindBuffer(GL_DRAW_INDIRECT_BUFFER);
+    multi_draw(drawMode, range.offset, counts);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// setBaseInstance
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::setBaseInstance(const GroupEntry& entry, const GLuint baseInstance) {
+    const auto live = m_live.find(entry.offset);
+    if (live == m_live.end() || !(live->second == entry))
+        return;
+    if (baseInstance != 0U)
+        m_baseInstances[entry.offset] = baseInstance;
+    else
+        m_baseInstances.erase(entry.offset);
+    m_commandsDirty = true;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -45,28 +205,56 @@ ModelGroup::ModelGroup(const size_t& count) : m_capacity(count) {
 
 void ModelGroup::resize(const size_t size) {
     if (size > m_capacity) {
-        // Create new set of VBO's large enough to fit old data + desired data
+        // Create a new VBO large enough to fit old data + desired data
         const auto delta = size - m_size;
+        const auto oldCapacity = m_capacity;
         m_capacity += delta * 2ULL;
+        const auto stride = static_cast<GLsizeiptr>(m_format.stride);
+        const auto used = stride * static_cast<GLsizeiptr>(m_size);
+        const auto newBytes = stride * static_cast<GLsizeiptr>(m_capacity);
 
-        // Create the new VBO's
-        GLuint newVBOID = 0;
-        glCreateBuffers(1, &newVBOID);
-        glNamedBufferStorage(newVBOID, m_capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        // Separate streams each start at an offset proportional to the capacity, so move each one
+        std::vector<CopyRegion> regions;
+        if (m_format.layout == VertexLayout::Separate)
+            for (size_t x = 0; x < m_format.attributes.size(); ++x)
+                regions.push_back(
+                    { m_format.streamOffset(x, oldCapacity), m_format.streamOffset(x, m_capacity),
+                      static_cast<GLsizeiptr>(m_format.attributes[x].size) * static_cast<GLsizeiptr>(m_size) });
+        else
+            regions.push_back({ 0, 0, used });
+        grow_storage(m_vboID, regions, newBytes, m_fence);
+        MemoryRegistry::Reallocate(MemoryRegistry::Category::ModelGroup, newBytes, used);
+        MemoryRegistry::Free(MemoryRegistry::Category::ModelGroup, m_vboBytes);
+        m_vboBytes = newBytes;
 
-        // Copy old VBO's
-        m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-        glCopyNamedBufferSubData(m_vboID, newVBOID, 0, 0, m_size);
+        // Assign VAOs to new VBO
+        m_format.bind(m_vaoID, m_vboID, m_capacity, m_format.attributes.size());
+        if (m_positionVaoID != 0U)
+            m_format.bind(m_positionVaoID, m_vboID, m_capacity, 1U);
+    }
+}
 
-        // Delete the old VBO's
-        wait_on_fence(m_fence);
-        glDeleteBuffers(1, &m_vboID);
+//////////////////////////////////////////////////////////////////////
+/// resize_indices
+//////////////////////////////////////////////////////////////////////
 
-        // Overwrite old VBO ID's
-        m_vboID = newVBOID;
+void ModelGroup::resize_indices(const GLsizeiptr bytes) {
+    if (bytes > m_eboBytes) {
+        // Create a new EBO large enough to fit old indices + desired indices
+        const auto newBytes = m_eboBytes + ((bytes - m_indexSize) * 2);
+        if (m_eboID == 0U) {
+            MemoryRegistry::Allocate(MemoryRegistry::Category::ModelGroup, newBytes);
+        } else {
+            MemoryRegistry::Reallocate(MemoryRegistry::Category::ModelGroup, newBytes, m_indexSize);
+            MemoryRegistry::Free(MemoryRegistry::Category::ModelGroup, m_eboBytes);
+        }
+        grow_storage(m_eboID, { { 0, 0, m_indexSize } }, newBytes, m_fence);
+        m_eboBytes = newBytes;
 
-        // Assign VAO to new VBO's
-        glVertexArrayVertexBuffer(m_vaoID, 0, m_vboID, 0, sizeof(vec3));
+        // Assign VAOs to new EBO
+        glVertexArrayElementBuffer(m_vaoID, m_eboID);
+        if (m_positionVaoID != 0U)
+            glVertexArrayElementBuffer(m_positionVaoID, m_eboID);
     }
 }
 
@@ -75,21 +263,539 @@ void ModelGroup::resize(const size_t size) {
 //////////////////////////////////////////////////////////////////////
 
 ModelGroup::GroupEntry ModelGroup::addModel(const std::vector<vec3>& data) {
-    // Expand container and ensure data is safe to manipulate
-    resize(m_size + data.size());
+    if (!positions_only())
+        return {};
+    return append(data.data(), data.size(), {}, GL_UNSIGNED_INT);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::GroupEntry ModelGroup::addModel(const Mesh& mesh) {
+    if (!positions_only())
+        return {};
+    const auto indexType = mini::IndexTypeFor(mesh.vertices.size());
+    return append(
+        mesh.vertices.data(), mesh.vertices.size(), mini::PackIndices(mesh.indices, indexType), indexType);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::GroupEntry ModelGroup::addModel(
+    const void* vertexData, const size_t vertexCount, const std::vector<GLuint>& indices) {
+    const auto indexType = mini::IndexTypeFor(vertexCount);
+    return append(vertexData, vertexCount, mini::PackIndices(indices, indexType), indexType);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// addModels
+//////////////////////////////////////////////////////////////////////
+
+std::vector<ModelGroup::GroupEntry> ModelGroup::addModels(const std::vector<MeshView>& meshes) {
+    // Lay every model out back to back, indices aligned to their own size with the padding left as holes
+    std::vector<GroupEntry> entries(meshes.size());
+    std::vector<std::pair<GLintptr, GLintptr>> paddings;
+    size_t totalVertices = 0U;
+    auto indexCursor = m_indexSize;
+    for (size_t x = 0; x < meshes.size(); ++x) {
+        auto& entry = entries[x];
+        entry.offset = static_cast<GLsizei>(m_size + totalVertices);
+        entry.count = static_cast<GLsizei>(meshes[x].vertexCount);
+        totalVertices += meshes[x].vertexCount;
+        if (meshes[x].vertexCount == 0U || meshes[x].indexCount == 0U)
+            continue;
+        entry.indexType = mini::IndexTypeFor(meshes[x].vertexCount);
+        const auto indexSize = static_cast<GLintptr>(mini::IndexTypeSize(entry.indexType));
+        entry.indexOffset = ((indexCursor + indexSize - 1) / indexSize) * indexSize;
+        entry.indexCount = static_cast<GLsizei>(meshes[x].indexCount);
+        if (entry.indexOffset > indexCursor)
+            paddings.emplace_back(indexCursor, entry.indexOffset - indexCursor);
+        indexCursor = entry.indexOffset + (indexSize * entry.indexCount);
+    }
+    if (totalVertices == 0U)
+        return entries;
+
+    // Pack everything into staging memory shaped like the destination ranges
+    std::vector<unsigned char> vertexStaging(static_cast<size_t>(m_format.stride) * totalVertices);
+    std::vector<unsigned char> indexStaging(static_cast<size_t>(indexCursor - m_indexSize));
+    for (size_t x = 0; x < meshes.size(); ++x) {
+        const auto& mesh = meshes[x];
+        const auto& entry = entries[x];
+        const auto first = static_cast<size_t>(entry.offset) - m_size;
+        const auto* source = static_cast<const unsigned char*>(mesh.vertexData);
+        if (mesh.vertexCount == 0U)
+            continue;
+        if (m_format.layout == VertexLayout::Separate)
+            for (size_t y = 0; y < m_format.attributes.size(); ++y) {
+                const auto size = static_cast<size_t>(m_format.attributes[y].size);
+                std::memcpy(
+                    &vertexStaging[static_cast<size_t>(m_format.streamOffset(y, totalVertices)) + (size * first)],
+                    source + m_format.streamOffset(y, mesh.vertexCount), size * mesh.vertexCount);
+            }
+        else
+            std::memcpy(
+                &vertexStaging[static_cast<size_t>(m_format.stride) * first], source,
+                static_cast<size_t>(m_format.stride) * mesh.vertexCount);
+        if (entry.indexCount == 0)
+            continue;
+
+        auto* target = &indexStaging[static_cast<size_t>(entry.indexOffset - m_indexSize)];
+        if (entry.indexType == GL_UNSIGNED_SHORT)
+            for (size_t y = 0; y < mesh.indexCount; ++y) {
+                const auto index = static_cast<GLushort>(mesh.indices[y]);
+                std::memcpy(target + (y * sizeof(GLushort)), &index, sizeof(GLushort));
+            }
+        else
+            std::memcpy(target, mesh.indices, mesh.indexCount * sizeof(GLuint));
+    }
+
+    // Grow each buffer at most once, then upload every model with a single fence
+    const auto first = m_size;
+    resize(m_size + totalVertices);
+    m_size += totalVertices;
+    const auto indexStart = m_indexSize;
+    if (indexCursor > m_indexSize) {
+        resize_indices(indexCursor);
+        m_indexSize = indexCursor;
+        for (const auto& padding : paddings)
+            release_range<GLintptr>(m_freeIndices, padding.first, padding.second, m_indexSize);
+    }
     wait_on_fence(m_fence);
+    if (m_format.layout == VertexLayout::Separate)
+        for (size_t x = 0; x < m_format.attributes.size(); ++x) {
+            const auto size = static_cast<GLsizeiptr>(m_format.attributes[x].size);
+            glNamedBufferSubData(
+                m_vboID, m_format.streamOffset(x, m_capacity) + (size * static_cast<GLsizeiptr>(first)),
+                size * static_cast<GLsizeiptr>(totalVertices),
+                &vertexStaging[static_cast<size_t>(m_format.streamOffset(x, totalVertices))]);
+        }
+    else
+        glNamedBufferSubData(
+            m_vboID, static_cast<GLintptr>(m_format.stride) * static_cast<GLintptr>(first),
+            static_cast<GLsizeiptr>(vertexStaging.size()), vertexStaging.data());
+    if (!indexStaging.empty())
+        glNamedBufferSubData(
+            m_eboID, indexStart, static_cast<GLsizeiptr>(indexStaging.size()), indexStaging.data());
+    m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
-    // Upload vertex data
-    const auto offset = static_cast<GLsizei>(m_size);
-    const auto count = static_cast<GLsizei>(data.size());
-    m_size += count;
-    glNamedBufferSubData(m_vboID, offset, count * sizeof(vec3), data.data());
+    // Track the new entries
+    for (const auto& entry : entries) {
+        if (entry.count == 0)
+            continue;
+        m_live[entry.offset] = entry;
+        if (entry.indexCount != 0)
+            m_liveIndices[entry.indexOffset] = entry.offset;
+    }
+    m_commandsDirty = true;
+    return entries;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+std::vector<ModelGroup::GroupEntry> ModelGroup::addModels(const std::vector<Mesh>& meshes) {
+    if (!positions_only())
+        return std::vector<GroupEntry>(meshes.size());
+    std::vector<MeshView> views;
+    views.reserve(meshes.size());
+    for (const auto& mesh : meshes)
+        views.push_back({ mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size() });
+    return addModels(views);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// append
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::GroupEntry ModelGroup::append(
+    const void* vertexData, const size_t vertexCount, const std::vector<unsigned char>& indices,
+    const GLenum indexType) {
+    const auto indexSize = static_cast<GLsizeiptr>(mini::IndexTypeSize(indexType));
+    const auto indexBytes = static_cast<GLsizeiptr>(indices.size());
+
+    // Reuse the first hole that fits, otherwise expand the container
+    size_t first = 0U;
+    if (vertexCount == 0U || !take_range<size_t>(m_freeVertices, vertexCount, 1U, first)) {
+        first = m_size;
+        resize(m_size + vertexCount);
+        m_size += vertexCount;
+    }
+    GLintptr indexOffset = 0;
+    if (indexBytes != 0 && !take_range<GLintptr>(m_freeIndices, indexBytes, indexSize, indexOffset)) {
+        // Indices must start on a multiple of their own size, the padding becomes a hole
+        indexOffset = ((m_indexSize + indexSize - 1) / indexSize) * indexSize;
+        resize_indices(indexOffset + indexBytes);
+        const auto padding = m_indexSize;
+        m_indexSize = indexOffset + indexBytes;
+        release_range<GLintptr>(m_freeIndices, padding, indexOffset - padding, m_indexSize);
+    }
+    wait_on_fence(m_fence);
+
+    // Upload vertex data, one stream at a time if separate
+    const auto offset = static_cast<GLsizei>(first);
+    const auto count = static_cast<GLsizei>(vertexCount);
+    const auto* source = static_cast<const unsigned char*>(vertexData);
+    if (m_format.layout == VertexLayout::Separate)
+        for (size_t x = 0; x < m_format.attributes.size(); ++x) {
+            const auto size = static_cast<GLsizeiptr>(m_format.attributes[x].size);
+            glNamedBufferSubData(
+                m_vboID, m_format.streamOffset(x, m_capacity) + (size * offset), size * count,
+                source + m_format.streamOffset(x, vertexCount));
+        }
+    else
+        glNamedBufferSubData(
+            m_vboID, static_cast<GLintptr>(m_format.stride) * offset, static_cast<GLsizeiptr>(m_format.stride) * count,
+            source);
+
+    // Upload index data
+    GroupEntry entry{ offset, count };
+    if (indexBytes != 0) {
+        glNamedBufferSubData(m_eboID, indexOffset, indexBytes, indices.data());
+        entry.indexOffset = indexOffset;
+        entry.indexCount = static_cast<GLsizei>(indexBytes / indexSize);
+        entry.indexType = indexType;
+        m_liveIndices[indexOffset] = offset;
+    }
+    if (count != 0) {
+        m_live[offset] = entry;
+        m_commandsDirty = true;
+    }
 
     // Prepare fence
     m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
     // Return entry position
-    return ModelGroup::GroupEntry{ offset, count };
+    return entry;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// removeModel
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::removeModel(const GroupEntry& entry) {
+    const auto live = m_live.find(entry.offset);
+    if (live == m_live.end() || !(live->second == entry))
+        return;
+    m_live.erase(live);
+    m_baseInstances.erase(entry.offset);
+    m_commandsDirty = true;
+
+    // Return both ranges as holes, a hole reaching the end shrinks the used size instead
+    release_range<size_t>(
+        m_freeVertices, static_cast<size_t>(entry.offset), static_cast<size_t>(entry.count), m_size);
+    if (entry.indexCount != 0) {
+        m_liveIndices.erase(entry.indexOffset);
+        release_range<GLintptr>(
+            m_freeIndices, entry.indexOffset,
+            static_cast<GLintptr>(entry.indexCount) * static_cast<GLintptr>(mini::IndexTypeSize(entry.indexType)),
+            m_indexSize);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// compact
+//////////////////////////////////////////////////////////////////////
+
+std::vector<ModelGroup::Relocation> ModelGroup::compact(const GLsizeiptr byteBudget) {
+    std::vector<Relocation> relocations;
+    GLsizeiptr remaining = byteBudget;
+    bool moved = false;
+    const auto record = [&relocations](const GroupEntry& from, const GroupEntry& to) {
+        // A model moved twice in one call is reported once, from where the caller last knew it
+        for (auto& relocation : relocations)
+            if (relocation.to == from) {
+                relocation.to = to;
+                return;
+            }
+        relocations.push_back({ from, to });
+    };
+
+    // Slide the model after the lowest vertex hole down into it, until no holes remain
+    while (!m_freeVertices.empty()) {
+        const auto hole = *m_freeVertices.begin();
+        const auto following = m_live.find(static_cast<GLsizei>(hole.first + hole.second));
+        if (following == m_live.end())
+            break;
+        const auto bytes = static_cast<GLsizeiptr>(m_format.stride) * following->second.count;
+        if (moved && bytes > remaining)
+            return relocations;
+        const auto before = following->second;
+        record(before, move_vertices(hole));
+        remaining -= bytes;
+        moved = true;
+    }
+
+    // Then the indices, skipping holes too small to hold the following model's indices once realigned
+    for (auto hole = m_freeIndices.begin(); hole != m_freeIndices.end();) {
+        const auto following = m_liveIndices.find(hole->first + hole->second);
+        const auto live = following != m_liveIndices.end() ? m_live.find(following->second) : m_live.end();
+        if (live == m_live.end())
+            break;
+        const auto& entry = live->second;
+        const auto indexSize = static_cast<GLintptr>(mini::IndexTypeSize(entry.indexType));
+        const auto target = ((hole->first + indexSize - 1) / indexSize) * indexSize;
+        if (target >= following->first) {
+            ++hole;
+            continue;
+        }
+        const auto bytes = static_cast<GLsizeiptr>(entry.indexCount) * indexSize;
+        if (moved && bytes > remaining)
+            break;
+        const auto before = entry;
+        const auto range = *hole;
+        record(before, move_indices(range, target));
+        remaining -= bytes;
+        moved = true;
+        hole = m_freeIndices.lower_bound(range.first);
+    }
+    return relocations;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// freeVertices
+//////////////////////////////////////////////////////////////////////
+
+size_t ModelGroup::freeVertices() const noexcept { return total_size(m_freeVertices); }
+
+//////////////////////////////////////////////////////////////////////
+/// freeIndexBytes
+//////////////////////////////////////////////////////////////////////
+
+GLsizeiptr ModelGroup::freeIndexBytes() const noexcept { return total_size(m_freeIndices); }
+
+//////////////////////////////////////////////////////////////////////
+/// move_vertices
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::GroupEntry ModelGroup::move_vertices(const std::pair<size_t, size_t>& hole) {
+    const auto from = static_cast<GLsizei>(hole.first + hole.second);
+    const auto to = static_cast<GLsizei>(hole.first);
+    auto entry = m_live[from];
+    m_live.erase(from);
+
+    // Copy on the GPU, one stream at a time if separate
+    if (m_format.layout == VertexLayout::Separate)
+        for (size_t x = 0; x < m_format.attributes.size(); ++x) {
+            const auto size = static_cast<GLsizeiptr>(m_format.attributes[x].size);
+            const auto base = m_format.streamOffset(x, m_capacity);
+            move_bytes(m_vboID, base + (size * from), base + (size * to), size * entry.count);
+        }
+    else {
+        const auto stride = static_cast<GLsizeiptr>(m_format.stride);
+        move_bytes(m_vboID, stride * from, stride * to, stride * entry.count);
+    }
+
+    // The hole now sits after the model, merging with whatever hole followed it
+    m_freeVertices.erase(hole.first);
+    release_range<size_t>(m_freeVertices, static_cast<size_t>(to + entry.count), hole.second, m_size);
+    entry.offset = to;
+    m_live[to] = entry;
+    if (entry.indexCount != 0)
+        m_liveIndices[entry.indexOffset] = to;
+    const auto instance = m_baseInstances.find(from);
+    if (instance != m_baseInstances.end()) {
+        m_baseInstances[to] = instance->second;
+        m_baseInstances.erase(from);
+    }
+    m_commandsDirty = true;
+    return entry;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// save
+//////////////////////////////////////////////////////////////////////
+
+bool ModelGroup::save(const std::string& path) const {
+    // Only the used ranges are kept, separate streams packed for exactly the used vertex count
+    std::vector<unsigned char> vertices(static_cast<size_t>(m_format.stride) * m_size);
+    std::vector<unsigned char> indices(static_cast<size_t>(m_indexSize));
+    if (m_size != 0U) {
+        if (m_format.layout == VertexLayout::Separate)
+            for (size_t x = 0; x < m_format.attributes.size(); ++x)
+                glGetNamedBufferSubData(
+                    m_vboID, m_format.streamOffset(x, m_capacity),
+                    static_cast<GLsizeiptr>(m_format.attributes[x].size) * static_cast<GLsizeiptr>(m_size),
+                    &vertices[static_cast<size_t>(m_format.streamOffset(x, m_size))]);
+        else
+            glGetNamedBufferSubData(m_vboID, 0, static_cast<GLsizeiptr>(vertices.size()), vertices.data());
+    }
+    if (!indices.empty())
+        glGetNamedBufferSubData(m_eboID, 0, m_indexSize, indices.data());
+
+    MeshCache::Contents contents;
+    contents.format = m_format;
+    contents.vertexCount = m_size;
+    contents.vertexData = vertices.data();
+    contents.indexData = indices.data();
+    contents.indexBytes = indices.size();
+    contents.entries.reserve(m_live.size());
+    for (const auto& live : m_live)
+        contents.entries.push_back(live.second);
+    return MeshCache::Write(path, contents);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// move_indices
+//////////////////////////////////////////////////////////////////////
+
+ModelGroup::GroupEntry ModelGroup::move_indices(const std::pair<GLintptr, GLintptr>& hole, const GLintptr target) {
+    const auto from = hole.first + hole.second;
+    const auto vertex = m_liveIndices[from];
+    m_liveIndices.erase(from);
+    auto& entry = m_live[vertex];
+    const auto bytes =
+        static_cast<GLsizeiptr>(entry.indexCount) * static_cast<GLsizeiptr>(mini::IndexTypeSize(entry.indexType));
+    move_bytes(m_eboID, from, target, bytes);
+
+    // Alignment padding stays behind as a hole of its own
+    m_freeIndices.erase(hole.first);
+    if (target > hole.first)
+        m_freeIndices[hole.first] = target - hole.first;
+    release_range<GLintptr>(m_freeIndices, target + bytes, from - target, m_indexSize);
+    entry.indexOffset = target;
+    m_liveIndices[target] = vertex;
+    m_commandsDirty = true;
+    return entry;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// create_vertex_buffer
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::create_vertex_buffer(const void* data) {
+    // Create GL Objects
+    glCreateVertexArrays(1, &m_vaoID);
+    glCreateBuffers(1, &m_vboID);
+
+    // Load geometry into vertex buffer object
+    m_vboBytes = static_cast<GLsizeiptr>(m_format.stride) * static_cast<GLsizeiptr>(m_capacity);
+    glNamedBufferStorage(m_vboID, m_vboBytes, data, GL_DYNAMIC_STORAGE_BIT);
+    MemoryRegistry::Allocate(MemoryRegistry::Category::ModelGroup, m_vboBytes);
+
+    // Connect and set-up the vertex array objects, a position-only one is only needed with other attributes
+    m_format.configure(m_vaoID, m_vboID, m_capacity);
+    if (m_format.attributes.size() > 1U) {
+        glCreateVertexArrays(1, &m_positionVaoID);
+        m_format.configurePositions(m_positionVaoID, m_vboID, m_capacity);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// restore_entries
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::restore_entries(const std::vector<GroupEntry>& entries) {
+    std::vector<std::pair<size_t, size_t>> vertexRanges;
+    std::vector<std::pair<GLintptr, GLintptr>> indexRanges;
+    for (const auto& entry : entries) {
+        if (entry.count == 0)
+            continue;
+        m_live[entry.offset] = entry;
+        vertexRanges.emplace_back(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.count));
+        if (entry.indexCount != 0) {
+            m_liveIndices[entry.indexOffset] = entry.offset;
+            indexRanges.emplace_back(
+                entry.indexOffset,
+                static_cast<GLintptr>(entry.indexCount) * static_cast<GLintptr>(mini::IndexTypeSize(entry.indexType)));
+        }
+    }
+
+    // Whatever no entry covers is free, trailing space is trimmed off the used sizes instead
+    std::sort(vertexRanges.begin(), vertexRanges.end());
+    std::sort(indexRanges.begin(), indexRanges.end());
+    size_t vertexCursor = 0U;
+    for (const auto& range : vertexRanges) {
+        if (range.first > vertexCursor)
+            release_range<size_t>(m_freeVertices, vertexCursor, range.first - vertexCursor, m_size);
+        vertexCursor = std::max(vertexCursor, range.first + range.second);
+    }
+    if (m_size > vertexCursor)
+        release_range<size_t>(m_freeVertices, vertexCursor, m_size - vertexCursor, m_size);
+    GLintptr indexCursor = 0;
+    for (const auto& range : indexRanges) {
+        if (range.first > indexCursor)
+            release_range<GLintptr>(m_freeIndices, indexCursor, range.first - indexCursor, m_indexSize);
+        indexCursor = std::max(indexCursor, range.first + range.second);
+    }
+    if (m_indexSize > indexCursor)
+        release_range<GLintptr>(m_freeIndices, indexCursor, m_indexSize - indexCursor, m_indexSize);
+    m_commandsDirty = true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// build_commands
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::build_commands(
+    const std::vector<GroupEntry>& entries, std::vector<unsigned char>& commands, GLsizei (&counts)[3]) const {
+    // Count each batch first so every command is written straight into place
+    const auto batch_of = [this](const GroupEntry& entry) {
+        const auto live = m_live.find(entry.offset);
+        if (live == m_live.end() || !(live->second == entry))
+            return -1;
+        if (entry.indexCount == 0)
+            return 0;
+        return entry.indexType == GL_UNSIGNED_SHORT ? 1 : 2;
+    };
+    counts[0] = counts[1] = counts[2] = 0;
+    for (const auto& entry : entries) {
+        const auto batch = batch_of(entry);
+        if (batch >= 0)
+            ++counts[batch];
+    }
+    constexpr size_t arraysSize = sizeof(DrawArraysIndirectCommand);
+    constexpr size_t elementsSize = sizeof(DrawElementsIndirectCommand);
+    commands.resize(
+        (arraysSize * static_cast<size_t>(counts[0])) + (elementsSize * static_cast<size_t>(counts[1] + counts[2])));
+    size_t cursors[3] = { 0U, arraysSize * static_cast<size_t>(counts[0]),
+                          (arraysSize * static_cast<size_t>(counts[0]))
+                              + (elementsSize * static_cast<size_t>(counts[1])) };
+
+    for (const auto& entry : entries) {
+        const auto batch = batch_of(entry);
+        if (batch < 0)
+            continue;
+        const auto instance = m_baseInstances.find(entry.offset);
+        const auto baseInstance = instance != m_baseInstances.end() ? instance->second : 0U;
+        if (batch == 0) {
+            const DrawArraysIndirectCommand command{
+                static_cast<GLuint>(entry.count), 1U, static_cast<GLuint>(entry.offset), baseInstance
+            };
+            std::memcpy(&commands[cursors[0]], &command, arraysSize);
+            cursors[0] += arraysSize;
+        } else {
+            const auto indexSize = static_cast<GLintptr>(mini::IndexTypeSize(entry.indexType));
+            const DrawElementsIndirectCommand command{ static_cast<GLuint>(entry.indexCount), 1U,
+                                                       static_cast<GLuint>(entry.indexOffset / indexSize),
+                                                       entry.offset, baseInstance };
+            std::memcpy(&commands[cursors[batch]], &command, elementsSize);
+            cursors[batch] += elementsSize;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// multi_draw
+//////////////////////////////////////////////////////////////////////
+
+void ModelGroup::multi_draw(const int drawMode, const GLintptr offset, const GLsizei (&counts)[3]) noexcept {
+    const auto mode = static_cast<GLenum>(drawMode);
+    auto cursor = offset;
+    if (counts[0] != 0)
+        glMultiDrawArraysIndirect(mode, reinterpret_cast<const void*>(cursor), counts[0], 0);
+    cursor += static_cast<GLintptr>(sizeof(DrawArraysIndirectCommand)) * counts[0];
+    if (counts[1] != 0)
+        glMultiDrawElementsIndirect(mode, GL_UNSIGNED_SHORT, reinterpret_cast<const void*>(cursor), counts[1], 0);
+    cursor += static_cast<GLintptr>(sizeof(DrawElementsIndirectCommand)) * counts[1];
+    if (counts[2] != 0)
+        glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(cursor), counts[2], 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// positions_only
+//////////////////////////////////////////////////////////////////////
+
+bool ModelGroup::positions_only() const noexcept {
+    // A lone attribute is laid out identically whether interleaved or separate
+    return m_format.attributes.size() == 1U && m_format.attributes[0] == mini::VertexTraits<vec3>::Format;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -102,11 +808,144 @@ static void wait_on_fence(GLsync& fence) noexcept {
         return;
     }
 
-    // Wait for data fence to be passed
-    GLenum state = GL_UNSIGNALED;
-    while (state != GL_SIGNALED && state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED) {
-        state = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1);
+    // Wait for data fence to be passed, the storage behind it is about to be reused
+    static auto& s_site = glFence::FindSite("ModelGroup");
+    glFence::WaitUntilSignaled(fence, s_site);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// grow_storage
+//////////////////////////////////////////////////////////////////////
+
+static void grow_storage(
+    GLuint& bufferID, const std::vector<CopyRegion>& regions, const GLsizeiptr newBytes, GLsync& fence) {
+    // Create the new buffer
+    GLuint newBufferID = 0;
+    glCreateBuffers(1, &newBufferID);
+    glNamedBufferStorage(newBufferID, newBytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    if (bufferID != 0U) {
+        // Copy the old buffer, the new fence follows everything the previous one did
+        glDeleteSync(fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        for (const auto& region : regions)
+            if (region.size != 0)
+                glCopyNamedBufferSubData(bufferID, newBufferID, region.from, region.to, region.size);
+
+        // Delete the old buffer
+        wait_on_fence(fence);
+        glDeleteBuffers(1, &bufferID);
+    }
+    bufferID = newBufferID;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// draw_commands
+//////////////////////////////////////////////////////////////////////
+
+static void draw_commands(
+    const int drawMode, const std::vector<unsigned char>& commands, const GLsizei (&counts)[3]) noexcept {
+    const auto mode = static_cast<GLenum>(drawMode);
+    const auto* cursor = commands.data();
+    for (GLsizei x = 0; x < counts[0]; ++x) {
+        ModelGroup::DrawArraysIndirectCommand command;
+        std::memcpy(&command, cursor, sizeof(command));
+        cursor += sizeof(command);
+        glDrawArraysInstancedBaseInstance(
+            mode, static_cast<GLint>(command.first), static_cast<GLsizei>(command.count),
+            static_cast<GLsizei>(command.instanceCount), command.baseInstance);
+    }
+    for (size_t batch = 1; batch < 3U; ++batch) {
+        const auto indexType = batch == 1U ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        const auto indexSize = mini::IndexTypeSize(indexType);
+        for (GLsizei x = 0; x < counts[batch]; ++x) {
+            ModelGroup::DrawElementsIndirectCommand command;
+            std::memcpy(&command, cursor, sizeof(command));
+            cursor += sizeof(command);
+            glDrawElementsInstancedBaseVertexBaseInstance(
+                mode, static_cast<GLsizei>(command.count), indexType,
+                reinterpret_cast<const void*>(static_cast<uintptr_t>(command.firstIndex) * indexSize),
+                static_cast<GLsizei>(command.instanceCount), command.baseVertex, command.baseInstance);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// move_bytes
+//////////////////////////////////////////////////////////////////////
+
+static void move_bytes(const GLuint bufferID, GLintptr from, GLintptr to, GLsizeiptr size) noexcept {
+    // Copies within a buffer must not overlap, so step no further than the distance moved
+    const auto step = static_cast<GLsizeiptr>(from - to);
+    while (size > 0) {
+        const auto chunk = std::min(size, step);
+        glCopyNamedBufferSubData(bufferID, bufferID, from, to, chunk);
+        from += chunk;
+        to += chunk;
+        size -= chunk;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// take_range
+//////////////////////////////////////////////////////////////////////
+
+template <typename T> static bool take_range(std::map<T, T>& holes, const T size, const T alignment, T& offset) {
+    // First fit, splitting off whatever the range doesn't use
+    for (auto hole = holes.begin(); hole != holes.end(); ++hole) {
+        const auto start = hole->first;
+        const auto end = hole->first + hole->second;
+        const auto aligned = ((start + alignment - 1) / alignment) * alignment;
+        if (aligned + size > end)
+            continue;
+        holes.erase(hole);
+        if (aligned > start)
+            holes[start] = aligned - start;
+        if (aligned + size < end)
+            holes[aligned + size] = end - (aligned + size);
+        offset = aligned;
+        return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// release_range
+//////////////////////////////////////////////////////////////////////
+
+template <typename T, typename U> static void release_range(std::map<T, T>& holes, T offset, T size, U& used) {
+    if (size == 0)
+        return;
+
+    // Merge with the neighbouring holes
+    const auto next = holes.lower_bound(offset);
+    if (next != holes.begin()) {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            holes.erase(previous);
+        }
+    }
+    if (next != holes.end() && offset + size == next->first) {
+        size += next->second;
+        holes.erase(next);
     }
-    glDeleteSync(fence);
-    fence = nullptr;
+
+    // A hole reaching the end of the used range just shrinks it
+    if (static_cast<U>(offset + size) == used)
+        used = static_cast<U>(offset);
+    else
+        holes[offset] = size;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// total_size
+//////////////////////////////////////////////////////////////////////
+
+template <typename T> static T total_size(const std::map<T, T>& holes) noexcept {
+    T total = 0;
+    for (const auto& hole : holes)
+        total += hole.second;
+    return total;
 }
\ No newline at end of file
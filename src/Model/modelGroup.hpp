@@ -2,11 +2,20 @@
 #ifndef MINIGFX_MODELGROUP_HPP
 #define MINIGFX_MODELGROUP_HPP
 
+#include "Buffer/glDynamicBuffer.hpp"
+#include "Buffer/glRingBuffer.hpp"
+#include "Model/mesh.hpp"
+#include "Model/vertexFormat.hpp"
 #include "Utility/vec.hpp"
 #include <glad/glad.h>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace mini {
+class MeshCache;
+
 //////////////////////////////////////////////////////////////////////
 /// \class  ModelGroup
 /// \brief  A vector-like container of models.
@@ -15,44 +24,192 @@ class ModelGroup {
     //////////////////////////////////////////////////////////////////////
     /// \brief  Defines an entry position and count within the container.
     struct GroupEntry {
-        GLsizei offset = 0; ///< Offset into the container memory.
-        GLsizei count = 0;  ///< Number of vertices.
+        GLsizei offset = 0;                 ///< Offset of the first vertex into the container memory.
+        GLsizei count = 0;                  ///< Number of vertices.
+        GLintptr indexOffset = 0;           ///< Byte offset of the first index into the element buffer.
+        GLsizei indexCount = 0;             ///< Number of indices, 0 if not indexed.
+        GLenum indexType = GL_UNSIGNED_INT; ///< The type of each index, relative to the first vertex.
+
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Compare two entries.
+        /// \return true if they refer to the same ranges.
+        bool operator==(const GroupEntry& o) const noexcept {
+            return offset == o.offset && count == o.count && indexOffset == o.indexOffset
+                   && indexCount == o.indexCount && indexType == o.indexType;
+        }
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  One non-indexed draw, as read by glMultiDrawArraysIndirect.
+    struct DrawArraysIndirectCommand {
+        GLuint count = 0U;         ///< Number of vertices.
+        GLuint instanceCount = 1U; ///< Number of instances.
+        GLuint first = 0U;         ///< First vertex.
+        GLuint baseInstance = 0U;  ///< First instance, usable as a per-draw ID.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  One indexed draw, as read by glMultiDrawElementsIndirect.
+    struct DrawElementsIndirectCommand {
+        GLuint count = 0U;         ///< Number of indices.
+        GLuint instanceCount = 1U; ///< Number of instances.
+        GLuint firstIndex = 0U;    ///< First index, in indices rather than bytes.
+        GLint baseVertex = 0;      ///< Added to every index.
+        GLuint baseInstance = 0U;  ///< First instance, usable as a per-draw ID.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Borrowed geometry for bulk loading, packed in the container's format and layout.
+    struct MeshView {
+        const void* vertexData = nullptr; ///< Vertex data packed in the container's format and layout.
+        size_t vertexCount = 0U;          ///< The number of vertices packed.
+        const GLuint* indices = nullptr;  ///< Indices into the vertices, 3 per triangle, null if not indexed.
+        size_t indexCount = 0U;           ///< The number of indices.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Where compaction moved an entry.
+    struct Relocation {
+        GroupEntry from; ///< The entry as it was before compacting.
+        GroupEntry to;   ///< The entry to draw with from now on.
     };
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy this model-group.
     ~ModelGroup();
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Construct a model-group container.
+    /// \brief  Construct a model-group container of positions only.
     /// \param  count       how many vertices to pre-allocate.
     ModelGroup(const size_t& count = 1024);
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default move constructor.
-    ModelGroup(ModelGroup&& o) noexcept = default;
+    /// \brief  Construct a model-group container of any vertex format.
+    /// \param  format      the format and layout every model's vertices are stored with.
+    /// \param  count       how many vertices to pre-allocate.
+    explicit ModelGroup(const VertexDescription& format, const size_t& count = 1024);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a model-group from a mapped cache, restoring every entry it holds.
+    /// \note   Without extra capacity, the blobs are handed straight to buffer storage.
+    /// \param  cache       an open cache, usually written by save().
+    /// \param  count       how many vertices to pre-allocate, at least the cache's vertex count.
+    explicit ModelGroup(const MeshCache& cache, const size_t& count = 0);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    ModelGroup(ModelGroup&& o) noexcept { (*this) = std::move(o); }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default move-assignment operator.
-    ModelGroup& operator=(ModelGroup&& p) noexcept = default;
+    /// \brief  Move-assignment operator, swapping so the other group releases this one's objects.
+    ModelGroup& operator=(ModelGroup&& p) noexcept;
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Bind this model-group to the current context for rendering.
     void bind() const noexcept { glBindVertexArray(m_vaoID); }
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind only this model-group's positions, for passes such as depth-only or shadows.
+    /// \note   With a separate layout, no other attribute stream is fetched.
+    void bindPositions() const noexcept { glBindVertexArray(m_positionVaoID != 0U ? m_positionVaoID : m_vaoID); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the format and layout of this model-group's vertices.
+    /// \return the vertex description.
+    const VertexDescription& format() const noexcept { return m_format; }
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Draw this model.
     /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
     /// \param  entry       range of the container to draw.
     static void draw(const int drawMode, const GroupEntry& entry) noexcept {
-        glDrawArrays(static_cast<GLenum>(drawMode), entry.offset, entry.count);
+        if (entry.indexCount != 0)
+            glDrawElementsBaseVertex(
+                static_cast<GLenum>(drawMode), entry.indexCount, entry.indexType,
+                reinterpret_cast<const void*>(entry.indexOffset), entry.offset);
+        else
+            glDrawArrays(static_cast<GLenum>(drawMode), entry.offset, entry.count);
     }
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Expand the container to at least this size.
+    /// \brief  Draw every live model, with one multi-draw per index type.
+    /// \note   Reads from a persistent mirror of indirect commands, rebuilt only after the models change.
+    /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+    void draw(const int drawMode);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Draw a subset of the live models, with one multi-draw per index type.
+    /// \note   The commands are written into the ring, retire it once the frame is submitted.
+    ///         Falls back to a draw per entry if the ring is full.
+    /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+    /// \param  visible     the entries to draw, entries no longer live are skipped.
+    /// \param  ring        the ring buffer to write this frame's commands into.
+    void draw(const int drawMode, const std::vector<GroupEntry>& visible, glRingBuffer& ring) const;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Assign the base instance a model is drawn with, so shaders can fetch per-object data.
+    /// \note   Read through gl_BaseInstance, or an instanced attribute with a divisor of 1.
+    /// \param  entry       the model's entry.
+    /// \param  baseInstance    the ID to draw the model with, 0 by default.
+    void setBaseInstance(const GroupEntry& entry, const GLuint baseInstance);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Expand the container to at least this many vertices.
     /// \param  size        the new size to use(if larger).
     void resize(const size_t size);
     //////////////////////////////////////////////////////////////////////
     /// \brief  Add a model to the end of the container.
     /// \param  data        the geometric data to use.
-    /// \return entry tag corresponding to this model.
+    /// \return entry tag corresponding to this model, empty if the container holds more than positions.
     GroupEntry addModel(const std::vector<vec3>& data);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add a mesh to the end of the container, indexed if the mesh is.
+    /// \note   Indices are stored as 16-bit whenever the mesh's vertex count allows it.
+    /// \param  mesh        the mesh to use.
+    /// \return entry tag corresponding to this model, empty if the container holds more than positions.
+    GroupEntry addModel(const Mesh& mesh);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add already packed vertex data to the end of the container.
+    /// \param  vertexData  vertex data packed in this container's format and layout.
+    /// \param  vertexCount the number of vertices packed.
+    /// \param  indices     indices into the vertices, 3 per triangle, empty if not indexed.
+    /// \return entry tag corresponding to this model.
+    GroupEntry addModel(const void* vertexData, const size_t vertexCount, const std::vector<GLuint>& indices = {});
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add one stream per attribute to the end of the container.
+    /// \param  indices     indices into the vertices, 3 per triangle, empty if not indexed.
+    /// \param  positions   the position of each vertex.
+    /// \param  streams     the remaining attributes of each vertex.
+    /// \return entry tag corresponding to this model, empty if the streams don't match the container's format.
+    template <typename Position, typename... Attributes>
+    GroupEntry addModel(
+        const std::vector<GLuint>& indices, const std::vector<Position>& positions,
+        const std::vector<Attributes>&... streams) {
+        using Format = VertexFormat<Position, Attributes...>;
+        if (Format::Describe(m_format.layout) != m_format)
+            return {};
+        return addModel(Format::Pack(m_format.layout, positions, streams...).data(), positions.size(), indices);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add many models at once, growing at most once and uploading them in a single pass.
+    /// \note   The models are appended contiguously after the used size, holes are left for addModel().
+    /// \param  meshes      the geometry of each model, only read during this call.
+    /// \return entry tag corresponding to each model, in the same order.
+    std::vector<GroupEntry> addModels(const std::vector<MeshView>& meshes);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Add many meshes at once, growing at most once and uploading them in a single pass.
+    /// \param  meshes      the meshes to use.
+    /// \return entry tag corresponding to each mesh, empty if the container holds more than positions.
+    std::vector<GroupEntry> addModels(const std::vector<Mesh>& meshes);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a model, freeing its ranges for reuse by later models.
+    /// \note   Unknown or already removed entries are ignored. Draws already issued are unaffected.
+    /// \param  entry       the entry returned when the model was added, or by compact().
+    void removeModel(const GroupEntry& entry);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Slide live models down into the holes removals left behind, on the GPU.
+    /// \note   Call once per frame. At least one model is moved per call, so progress is guaranteed.
+    /// \param  byteBudget  how many vertex and index bytes may be copied during this call.
+    /// \return every entry that moved, which must be drawn with its new value from now on.
+    std::vector<Relocation> compact(const GLsizeiptr byteBudget);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how many vertices sit in holes between live models.
+    /// \return the number of free vertices below the used size.
+    size_t freeVertices() const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how many element buffer bytes sit in holes between live models.
+    /// \return the number of free index bytes below the used size.
+    GLsizeiptr freeIndexBytes() const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Read this model-group back from the GPU and write it as a cache file, entries included.
+    /// \param  path        the file to write, replaced if it exists.
+    /// \return true on success.
+    bool save(const std::string& path) const;
 
     private:
     //////////////////////////////////////////////////////////////////////
@@ -62,13 +219,79 @@ class ModelGroup {
     /// \brief  Deleted copy-assignment operator.
     ModelGroup& operator=(const ModelGroup& p) = delete;
 
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Create the vertex buffer at the current capacity, and the VAOs reading it.
+    /// \param  data        vertex data for the whole capacity, or nullptr to leave it uninitialized.
+    void create_vertex_buffer(const void* data);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Rebuild the live entries and the free lists from a set of entries.
+    /// \param  entries     the entries to restore, every gap between them becomes a hole.
+    void restore_entries(const std::vector<GroupEntry>& entries);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Expand the element buffer to at least this many bytes.
+    /// \param  bytes       the new byte-size to use(if larger).
+    void resize_indices(const GLsizeiptr bytes);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Append packed vertices and packed indices to the container.
+    /// \param  vertexData  vertex data packed in this container's format and layout.
+    /// \param  vertexCount the number of vertices packed.
+    /// \param  indices     the packed indices to append, empty if not indexed.
+    /// \param  indexType   the type the indices were packed as.
+    /// \return entry tag corresponding to the appended model.
+    GroupEntry append(
+        const void* vertexData, const size_t vertexCount, const std::vector<unsigned char>& indices,
+        const GLenum indexType);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a live model's vertices down into the hole just before them.
+    /// \param  hole        the free range, ending where the model's vertices start.
+    /// \return the moved entry.
+    GroupEntry move_vertices(const std::pair<size_t, size_t>& hole);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a live model's indices down into the hole just before them.
+    /// \param  hole        the free range, ending where the model's indices start.
+    /// \param  target      the aligned offset to move the indices to.
+    /// \return the moved entry.
+    GroupEntry move_indices(const std::pair<GLintptr, GLintptr>& hole, const GLintptr target);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Sort commands for the live entries provided into non-indexed, 16-bit and 32-bit batches.
+    /// \param  entries     the entries to build commands for, entries no longer live are skipped.
+    /// \param  commands    packed as every arrays command, then every short, then every int elements command.
+    /// \param  counts      the number of commands in each batch.
+    void build_commands(
+        const std::vector<GroupEntry>& entries, std::vector<unsigned char>& commands, GLsizei (&counts)[3]) const;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Issue a multi-draw per non-empty batch from the bound indirect buffer.
+    /// \param  drawMode    either GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+    /// \param  offset      byte offset of the first batch within the indirect buffer.
+    /// \param  counts      the number of commands in each batch.
+    static void multi_draw(const int drawMode, const GLintptr offset, const GLsizei (&counts)[3]) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Check whether this container holds nothing but float positions.
+    /// \return true if plain vec3 vertices can be appended as-is.
+    bool positions_only() const noexcept;
+
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    size_t m_size = 0ULL;     ///< The number of bytes used.
-    size_t m_capacity = 0ULL; ///< The total capacity allocated.
-    GLuint m_vaoID = 0U;      ///< The OpenGL vertex array object ID.
-    GLuint m_vboID = 0U;      ///< The OpenGL vertex buffer object ID.
-    GLsync m_fence = nullptr; ///< A sync fence to avoid race conditions.
+    size_t m_size = 0ULL;                       ///< The number of vertices used.
+    size_t m_capacity = 0ULL;                   ///< The number of vertices allocated.
+    GLsizeiptr m_indexSize = 0;                 ///< The number of element buffer bytes used.
+    GLuint m_vaoID = 0U;                        ///< The OpenGL vertex array object ID.
+    GLuint m_positionVaoID = 0U;                ///< A VAO with only the position, 0 if unneeded.
+    GLuint m_vboID = 0U;                        ///< The OpenGL vertex buffer object ID.
+    GLuint m_eboID = 0U;                        ///< The OpenGL element buffer object ID.
+    GLsizeiptr m_vboBytes = 0;                  ///< Byte-size of the vertex buffer object's storage.
+    GLsizeiptr m_eboBytes = 0;                  ///< Byte-size of the element buffer object's storage.
+    GLsync m_fence = nullptr;                   ///< A sync fence to avoid race conditions.
+    VertexDescription m_format;                 ///< The format and layout of the vertices.
+    std::map<GLsizei, GroupEntry> m_live;       ///< Every live entry, keyed by first vertex.
+    std::map<GLintptr, GLsizei> m_liveIndices;  ///< First vertex of every indexed entry, keyed by index offset.
+    std::map<size_t, size_t> m_freeVertices;    ///< Holes in the vertex buffer, first vertex to count.
+    std::map<GLintptr, GLintptr> m_freeIndices; ///< Holes in the element buffer, byte offset to size.
+    std::map<GLsizei, GLuint> m_baseInstances;  ///< Non-zero base instances, keyed by first vertex.
+    glDynamicBuffer m_commands;                 ///< Persistent mirror of an indirect command per live entry.
+    std::vector<unsigned char> m_commandData;   ///< CPU copy of the mirror, reused between rebuilds.
+    GLsizei m_commandCounts[3] = {};            ///< Commands per batch in the mirror, arrays then short then int.
+    bool m_commandsDirty = true;                ///< Whether the mirror is out of date with the live entries.
 };
 }; // namespace mini
 
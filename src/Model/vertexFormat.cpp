@@ -0,0 +1,75 @@
+#include "Model/vertexFormat.hpp"
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::VertexAttributeFormat;
+using mini::VertexDescription;
+using mini::VertexLayout;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static void format_attribute(
+    const GLuint /*vaoID*/, const GLuint /*location*/, const VertexAttributeFormat& /*attribute*/,
+    const GLuint /*relativeOffset*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// configure
+//////////////////////////////////////////////////////////////////////
+
+void VertexDescription::configure(const GLuint vaoID, const GLuint bufferID, const size_t vertexCount) const
+    noexcept {
+    for (size_t x = 0; x < attributes.size(); ++x) {
+        // Interleaved attributes share binding 0, separate streams get a binding each
+        const auto location = static_cast<GLuint>(x);
+        const auto separate = layout == VertexLayout::Separate;
+        glEnableVertexArrayAttrib(vaoID, location);
+        glVertexArrayAttribBinding(vaoID, location, separate ? location : 0U);
+        format_attribute(vaoID, location, attributes[x], separate ? 0U : attributes[x].offset);
+    }
+    bind(vaoID, bufferID, vertexCount, attributes.size());
+}
+
+//////////////////////////////////////////////////////////////////////
+/// configurePositions
+//////////////////////////////////////////////////////////////////////
+
+void VertexDescription::configurePositions(const GLuint vaoID, const GLuint bufferID, const size_t vertexCount) const
+    noexcept {
+    if (attributes.empty())
+        return;
+    glEnableVertexArrayAttrib(vaoID, 0U);
+    glVertexArrayAttribBinding(vaoID, 0U, 0U);
+    format_attribute(vaoID, 0U, attributes[0], 0U);
+    bind(vaoID, bufferID, vertexCount, 1U);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// bind
+//////////////////////////////////////////////////////////////////////
+
+void VertexDescription::bind(
+    const GLuint vaoID, const GLuint bufferID, const size_t vertexCount, const size_t attributeCount) const noexcept {
+    if (layout == VertexLayout::Interleaved) {
+        // Position-only VAOs still step over the whole vertex, the position is always first
+        glVertexArrayVertexBuffer(vaoID, 0U, bufferID, 0, stride);
+        return;
+    }
+    for (size_t x = 0; x < attributeCount && x < attributes.size(); ++x)
+        glVertexArrayVertexBuffer(
+            vaoID, static_cast<GLuint>(x), bufferID, streamOffset(x, vertexCount),
+            static_cast<GLsizei>(attributes[x].size));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// format_attribute
+//////////////////////////////////////////////////////////////////////
+
+static void format_attribute(
+    const GLuint vaoID, const GLuint location, const VertexAttributeFormat& attribute,
+    const GLuint relativeOffset) noexcept {
+    if (attribute.integer)
+        glVertexArrayAttribIFormat(vaoID, location, attribute.components, attribute.type, relativeOffset);
+    else
+        glVertexArrayAttribFormat(
+            vaoID, location, attribute.components, attribute.type, attribute.normalized, relativeOffset);
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+#ifndef MINIGFX_VERTEXFORMAT_HPP
+#define MINIGFX_VERTEXFORMAT_HPP
+
+#include "Utility/vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <glad/glad.h>
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  How a vertex format's attributes are arranged in a buffer.
+enum class VertexLayout {
+    Interleaved, ///< Every attribute of a vertex sits together, one binding for all of them.
+    Separate     ///< Each attribute is its own tightly packed stream, one binding per attribute.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  An octahedral normal, two snorm16 values, see EncodeOctahedralNormals.
+struct PackedNormal {
+    uint32_t value = 0U; ///< x in the low half, y in the high half.
+};
+//////////////////////////////////////////////////////////////////////
+/// \brief  A texture coordinate as two unorm16 values, see QuantizeUVs.
+struct PackedUV {
+    uint32_t value = 0U; ///< u in the low half, v in the high half.
+};
+//////////////////////////////////////////////////////////////////////
+/// \brief  An RGBA color as four unorm8 values.
+struct PackedColor {
+    uint32_t value = 0U; ///< r in the lowest byte, a in the highest.
+};
+//////////////////////////////////////////////////////////////////////
+/// \brief  A position as three half floats plus padding, see QuantizePositions.
+struct HalfPosition {
+    uint16_t value[4] = {}; ///< x, y, z, then padding.
+};
+//////////////////////////////////////////////////////////////////////
+/// \brief  A position as three unorm16 values plus padding, see QuantizePositions.
+struct Unorm16Position {
+    uint16_t value[4] = {}; ///< x, y, z, then padding.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  How one attribute is fetched, as passed to glVertexArrayAttrib(I)Format.
+struct VertexAttributeFormat {
+    GLint components = 0;            ///< Number of components fetched.
+    GLenum type = GL_FLOAT;          ///< The type of each component.
+    GLboolean normalized = GL_FALSE; ///< Whether integer components are normalized.
+    bool integer = false;            ///< Whether the shader reads integers rather than floats.
+    GLuint size = 0U;                ///< Bytes occupied per vertex.
+    GLuint offset = 0U;              ///< Bytes of all earlier attributes per vertex.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compare two attribute formats.
+    /// \return true if they are fetched identically.
+    bool operator==(const VertexAttributeFormat& o) const noexcept {
+        return components == o.components && type == o.type && normalized == o.normalized && integer == o.integer
+               && size == o.size && offset == o.offset;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  How a C++ type is fetched as a vertex attribute.
+template <typename T> struct VertexTraits;
+template <> struct VertexTraits<float> {
+    static constexpr VertexAttributeFormat Format{ 1, GL_FLOAT, GL_FALSE, false, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<vec2> {
+    static constexpr VertexAttributeFormat Format{ 2, GL_FLOAT, GL_FALSE, false, 8U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<vec3> {
+    static constexpr VertexAttributeFormat Format{ 3, GL_FLOAT, GL_FALSE, false, 12U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<vec4> {
+    static constexpr VertexAttributeFormat Format{ 4, GL_FLOAT, GL_FALSE, false, 16U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<int> {
+    static constexpr VertexAttributeFormat Format{ 1, GL_INT, GL_FALSE, true, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<unsigned int> {
+    static constexpr VertexAttributeFormat Format{ 1, GL_UNSIGNED_INT, GL_FALSE, true, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<ivec2> {
+    static constexpr VertexAttributeFormat Format{ 2, GL_INT, GL_FALSE, true, 8U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<ivec3> {
+    static constexpr VertexAttributeFormat Format{ 3, GL_INT, GL_FALSE, true, 12U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<ivec4> {
+    static constexpr VertexAttributeFormat Format{ 4, GL_INT, GL_FALSE, true, 16U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<PackedNormal> {
+    static constexpr VertexAttributeFormat Format{ 2, GL_SHORT, GL_TRUE, false, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<PackedUV> {
+    static constexpr VertexAttributeFormat Format{ 2, GL_UNSIGNED_SHORT, GL_TRUE, false, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<PackedColor> {
+    static constexpr VertexAttributeFormat Format{ 4, GL_UNSIGNED_BYTE, GL_TRUE, false, 4U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<HalfPosition> {
+    static constexpr VertexAttributeFormat Format{ 3, GL_HALF_FLOAT, GL_FALSE, false, 8U, 0U }; ///< Fetch format.
+};
+template <> struct VertexTraits<Unorm16Position> {
+    static constexpr VertexAttributeFormat Format{ 3, GL_UNSIGNED_SHORT, GL_TRUE, false, 8U, 0U }; ///< Fetch format.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \struct VertexDescription
+/// \brief  A vertex format and layout, resolved at runtime so it can be stored and applied to VAOs.
+/// \note   Attribute locations match attribute order, the position is expected at location 0.
+struct VertexDescription {
+    VertexLayout layout = VertexLayout::Interleaved; ///< How the attributes are arranged.
+    GLsizei stride = 0;                              ///< Bytes per vertex across every attribute.
+    std::vector<VertexAttributeFormat> attributes;   ///< Each attribute, in location order.
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compare two descriptions.
+    /// \return true if they arrange identical attributes identically.
+    bool operator==(const VertexDescription& o) const noexcept {
+        return layout == o.layout && stride == o.stride && attributes == o.attributes;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compare two descriptions.
+    /// \return true if they differ.
+    bool operator!=(const VertexDescription& o) const noexcept { return !(*this == o); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve where an attribute's stream starts.
+    /// \param  attribute   the attribute to locate.
+    /// \param  vertexCount the number of vertices the buffer was laid out for.
+    /// \return the byte offset of the stream, always 0 when interleaved.
+    GLintptr streamOffset(const size_t attribute, const size_t vertexCount) const noexcept {
+        return layout == VertexLayout::Separate
+                   ? static_cast<GLintptr>(attributes[attribute].offset) * static_cast<GLintptr>(vertexCount)
+                   : 0;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Enable and format every attribute of a VAO, and bind them to a buffer.
+    /// \param  vaoID       the vertex array object to configure.
+    /// \param  bufferID    the buffer holding the vertices.
+    /// \param  vertexCount the number of vertices the buffer was laid out for.
+    void configure(const GLuint vaoID, const GLuint bufferID, const size_t vertexCount) const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Enable and format only the position attribute of a VAO, for depth-only style passes.
+    /// \param  vaoID       the vertex array object to configure.
+    /// \param  bufferID    the buffer holding the vertices.
+    /// \param  vertexCount the number of vertices the buffer was laid out for.
+    void configurePositions(const GLuint vaoID, const GLuint bufferID, const size_t vertexCount) const noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Re-point a configured VAO's bindings, after the buffer was replaced or re-laid out.
+    /// \param  vaoID       the vertex array object to update.
+    /// \param  bufferID    the buffer holding the vertices.
+    /// \param  vertexCount the number of vertices the buffer was laid out for.
+    /// \param  attributeCount  how many attributes the VAO was configured with.
+    void bind(const GLuint vaoID, const GLuint bufferID, const size_t vertexCount, const size_t attributeCount) const
+        noexcept;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \class  VertexFormat
+/// \brief  A vertex format described by its attribute types, computing offsets and
+///         strides at compile time.
+/// \note   The first attribute is the position, bound at location 0.
+template <typename Position, typename... Attributes> class VertexFormat {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the type of an attribute.
+    template <size_t I> using AttributeType = std::tuple_element_t<I, std::tuple<Position, Attributes...>>;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the bytes of all attributes before this one, per vertex.
+    /// \return the attribute's offset within an interleaved vertex.
+    template <size_t I> static constexpr size_t OffsetOf() noexcept {
+        constexpr std::array<size_t, AttributeCount> sizes{ sizeof(Position), sizeof(Attributes)... };
+        size_t offset = 0;
+        for (size_t x = 0; x < I; ++x)
+            offset += sizes[x];
+        return offset;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Describe this format at runtime.
+    /// \param  layout      how the attributes are arranged.
+    /// \return the description of this format.
+    static VertexDescription Describe(const VertexLayout layout) {
+        VertexDescription description{ layout, static_cast<GLsizei>(Stride), {} };
+        description.attributes = { VertexTraits<Position>::Format, VertexTraits<Attributes>::Format... };
+        GLuint offset = 0U;
+        for (auto& attribute : description.attributes) {
+            attribute.offset = offset;
+            offset += attribute.size;
+        }
+        return description;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Pack one stream per attribute into a single block of vertex data.
+    /// \note   The position stream sets the vertex count, shorter streams are zero-filled.
+    /// \param  layout      how to arrange the attributes.
+    /// \param  positions   the position of each vertex.
+    /// \param  streams     the remaining attributes of each vertex.
+    /// \return the packed vertex data.
+    static std::vector<unsigned char> Pack(
+        const VertexLayout layout, const std::vector<Position>& positions, const std::vector<Attributes>&... streams) {
+        std::vector<unsigned char> data(positions.size() * Stride, 0U);
+        pack(data.data(), layout, positions.size(), std::index_sequence_for<Position, Attributes...>{}, positions,
+             streams...);
+        return data;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Public Attributes
+    static constexpr size_t AttributeCount = sizeof...(Attributes) + 1U;                 ///< Number of attributes.
+    static constexpr size_t Stride = sizeof(Position) + (sizeof(Attributes) + ... + 0U); ///< Bytes per vertex.
+
+    private:
+    static_assert(
+        (std::is_trivially_copyable_v<Position> && ... && std::is_trivially_copyable_v<Attributes>),
+        "vertex attributes must be trivially copyable");
+    static_assert(
+        sizeof(Position) == VertexTraits<Position>::Format.size
+            && ((sizeof(Attributes) == VertexTraits<Attributes>::Format.size) && ...),
+        "vertex attributes must be tightly packed");
+    static_assert(
+        sizeof(Position) % 4U == 0U && ((sizeof(Attributes) % 4U == 0U) && ...),
+        "vertex attributes must be multiples of 4 bytes to stay aligned");
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Pack every stream, pairing each with its attribute index.
+    template <size_t... I, typename... Streams>
+    static void pack(
+        unsigned char* data, const VertexLayout layout, const size_t vertexCount, std::index_sequence<I...>,
+        const Streams&... streams) noexcept {
+        (pack_stream<I>(data, layout, vertexCount, streams), ...);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Pack a single attribute stream.
+    template <size_t I, typename T>
+    static void pack_stream(
+        unsigned char* data, const VertexLayout layout, const size_t vertexCount,
+        const std::vector<T>& stream) noexcept {
+        const auto count = std::min(vertexCount, stream.size());
+        if (count == 0U)
+            return;
+        if (layout == VertexLayout::Separate)
+            std::memcpy(data + (OffsetOf<I>() * vertexCount), stream.data(), sizeof(T) * count);
+        else
+            for (size_t x = 0; x < count; ++x)
+                std::memcpy(data + (x * Stride) + OffsetOf<I>(), &stream[x], sizeof(T));
+    }
+};
+}; // namespace mini
+
+#endif // MINIGFX_VERTEXFORMAT_HPP
\ No newline at end of file
@@ -0,0 +1,456 @@
+#include "Model/vertexQuantization.hpp"
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINIGFX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::PositionEncoding;
+using mini::QuantizationError;
+using mini::QuantizedPositions;
+using mini::vec2;
+using mini::vec3;
+constexpr float Unorm16Max = 65535.0F;
+constexpr float Snorm16Max = 32767.0F;
+constexpr float DegreesPerRadian = 57.2957795F;
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static uint16_t to_unorm16(const float /*value*/) noexcept;
+#if !defined(MINIGFX_SSE2)
+static int16_t to_snorm16(const float /*value*/) noexcept;
+static vec2 octahedral_fold(const vec3& /*normal*/) noexcept;
+#endif
+static void quantize_half_positions(
+    const std::vector<vec3>& /*positions*/, const vec3& /*offset*/, uint16_t* /*out*/) noexcept;
+static void quantize_unorm16_positions(
+    const std::vector<vec3>& /*positions*/, const vec3& /*offset*/, const vec3& /*invScale*/,
+    uint16_t* /*out*/) noexcept;
+static void encode_octahedral(const std::vector<vec3>& /*normals*/, uint32_t* /*out*/) noexcept;
+static void quantize_uvs(const std::vector<vec2>& /*uvs*/, uint32_t* /*out*/) noexcept;
+static void accumulate_error(QuantizationError& /*error*/, const float /*value*/) noexcept;
+static void finish_error(QuantizationError& /*error*/, const size_t /*count*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// FloatToHalf
+//////////////////////////////////////////////////////////////////////
+
+uint16_t mini::FloatToHalf(const float value) noexcept {
+    uint32_t bits = 0U;
+    std::memcpy(&bits, &value, sizeof(float));
+    const auto sign = static_cast<uint16_t>((bits >> 16U) & 0x8000U);
+    bits &= 0x7FFFFFFFU;
+
+    // Too large for a half, becomes infinity, NaN stays a quiet NaN
+    if (bits >= 0x47800000U)
+        return sign | (bits > 0x7F800000U ? 0x7E00U : 0x7C00U);
+
+    // Too small for a normal half, let the float adder round the subnormal for us
+    if (bits < 0x38800000U) {
+        float magnitude = 0.0F;
+        std::memcpy(&magnitude, &bits, sizeof(float));
+        magnitude += 0.5F;
+        std::memcpy(&bits, &magnitude, sizeof(float));
+        return sign | static_cast<uint16_t>(bits - 0x3F000000U);
+    }
+
+    // Rebias the exponent and round the mantissa to nearest even
+    const auto odd = (bits >> 13U) & 1U;
+    bits += 0xC8000FFFU + odd;
+    return sign | static_cast<uint16_t>(bits >> 13U);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// HalfToFloat
+//////////////////////////////////////////////////////////////////////
+
+float mini::HalfToFloat(const uint16_t value) noexcept {
+    const auto sign = static_cast<uint32_t>(value & 0x8000U) << 16U;
+    const auto exponent = static_cast<uint32_t>(value >> 10U) & 0x1FU;
+    const auto mantissa = static_cast<uint32_t>(value) & 0x3FFU;
+    uint32_t bits = sign;
+    if (exponent == 0x1FU)
+        bits |= 0x7F800000U | (mantissa << 13U);
+    else if (exponent != 0U)
+        bits |= ((exponent + 112U) << 23U) | (mantissa << 13U);
+    else if (mantissa != 0U) {
+        // Subnormal halves are exact floats, scale them directly
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0U ? -magnitude : magnitude;
+    }
+    float result = 0.0F;
+    std::memcpy(&result, &bits, sizeof(float));
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// QuantizePositions
+//////////////////////////////////////////////////////////////////////
+
+QuantizedPositions mini::QuantizePositions(const std::vector<vec3>& positions, const PositionEncoding encoding) {
+    QuantizedPositions quantized;
+    quantized.encoding = encoding == PositionEncoding::Half ? PositionEncoding::Half : PositionEncoding::Unorm16;
+    quantized.data.resize(positions.size() * 4U, 0U);
+    if (positions.empty())
+        return quantized;
+
+    vec3 minimum = positions[0];
+    vec3 maximum = positions[0];
+    for (const auto& position : positions) {
+        minimum = minimum.min(position);
+        maximum = maximum.max(position);
+    }
+
+    if (quantized.encoding == PositionEncoding::Half) {
+        // Centring the mesh spends the half's precision on the extent rather than the placement
+        quantized.offset = (minimum + maximum) * 0.5F;
+        quantize_half_positions(positions, quantized.offset, quantized.data.data());
+        return quantized;
+    }
+
+    // Stretch each axis across the full 16-bit range, flat axes keep a unit scale
+    quantized.offset = minimum;
+    vec3 invScale(0.0F);
+    for (size_t axis = 0; axis < 3U; ++axis) {
+        const float extent = maximum[axis] - minimum[axis];
+        quantized.scale[axis] = extent > 0.0F ? extent : 1.0F;
+        invScale[axis] = 1.0F / quantized.scale[axis];
+    }
+    quantize_unorm16_positions(positions, quantized.offset, invScale, quantized.data.data());
+    return quantized;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// DecodePosition
+//////////////////////////////////////////////////////////////////////
+
+vec3 mini::DecodePosition(const QuantizedPositions& positions, const size_t index) noexcept {
+    const auto* values = &positions.data[index * 4U];
+    vec3 attribute(0.0F);
+    for (size_t axis = 0; axis < 3U; ++axis)
+        attribute[axis] = positions.encoding == PositionEncoding::Half
+                              ? HalfToFloat(values[axis])
+                              : static_cast<float>(values[axis]) / Unorm16Max;
+    return positions.offset + positions.scale * attribute;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// EncodeOctahedralNormals
+//////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> mini::EncodeOctahedralNormals(const std::vector<vec3>& normals) {
+    std::vector<uint32_t> encoded(normals.size(), 0U);
+    encode_octahedral(normals, encoded.data());
+    return encoded;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// DecodeOctahedralNormal
+//////////////////////////////////////////////////////////////////////
+
+vec3 mini::DecodeOctahedralNormal(const uint32_t encoded) noexcept {
+    const auto packedX = static_cast<int16_t>(encoded & 0xFFFFU);
+    const auto packedY = static_cast<int16_t>(encoded >> 16U);
+    float x = std::max(static_cast<float>(packedX) / Snorm16Max, -1.0F);
+    float y = std::max(static_cast<float>(packedY) / Snorm16Max, -1.0F);
+    const float z = 1.0F - std::abs(x) - std::abs(y);
+    if (z < 0.0F) {
+        // Unfold the lower hemisphere back out of the corners
+        const float foldedX = (1.0F - std::abs(y)) * (x >= 0.0F ? 1.0F : -1.0F);
+        y = (1.0F - std::abs(x)) * (y >= 0.0F ? 1.0F : -1.0F);
+        x = foldedX;
+    }
+    return vec3(x, y, z).normalize();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// QuantizeUVs
+//////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> mini::QuantizeUVs(const std::vector<vec2>& uvs) {
+    std::vector<uint32_t> encoded(uvs.size(), 0U);
+    quantize_uvs(uvs, encoded.data());
+    return encoded;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// DecodeUV
+//////////////////////////////////////////////////////////////////////
+
+vec2 mini::DecodeUV(const uint32_t encoded) noexcept {
+    return vec2(
+        static_cast<float>(encoded & 0xFFFFU) / Unorm16Max, static_cast<float>(encoded >> 16U) / Unorm16Max);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// MeasurePositionError
+//////////////////////////////////////////////////////////////////////
+
+QuantizationError mini::MeasurePositionError(const std::vector<vec3>& positions, const QuantizedPositions& quantized) {
+    QuantizationError error;
+    const auto count = std::min(positions.size(), quantized.data.size() / 4U);
+    for (size_t x = 0; x < count; ++x)
+        accumulate_error(error, vec3::distance(positions[x], DecodePosition(quantized, x)));
+    finish_error(error, count);
+    return error;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// MeasureNormalError
+//////////////////////////////////////////////////////////////////////
+
+QuantizationError mini::MeasureNormalError(const std::vector<vec3>& normals, const std::vector<uint32_t>& encoded) {
+    QuantizationError error;
+    const auto count = std::min(normals.size(), encoded.size());
+    for (size_t x = 0; x < count; ++x) {
+        const float cosine = normals[x].normalize().dot(DecodeOctahedralNormal(encoded[x]));
+        accumulate_error(error, std::acos(std::min(std::max(cosine, -1.0F), 1.0F)) * DegreesPerRadian);
+    }
+    finish_error(error, count);
+    return error;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// MeasureUVError
+//////////////////////////////////////////////////////////////////////
+
+QuantizationError mini::MeasureUVError(const std::vector<vec2>& uvs, const std::vector<uint32_t>& encoded) {
+    QuantizationError error;
+    const auto count = std::min(uvs.size(), encoded.size());
+    for (size_t x = 0; x < count; ++x)
+        accumulate_error(error, vec2::distance(uvs[x], DecodeUV(encoded[x])));
+    finish_error(error, count);
+    return error;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// to_unorm16
+//////////////////////////////////////////////////////////////////////
+
+static uint16_t to_unorm16(const float value) noexcept {
+    // nearbyint rounds to nearest even, matching the SIMD conversion
+    return static_cast<uint16_t>(std::nearbyint(std::min(std::max(value, 0.0F), 1.0F) * Unorm16Max));
+}
+
+#if defined(MINIGFX_SSE2)
+//////////////////////////////////////////////////////////////////////
+/// quantize_half_positions
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_half_positions(const std::vector<vec3>& positions, const vec3& offset, uint16_t* out) noexcept {
+    // The same steps as FloatToHalf(), with every branch computed and the right one selected per lane
+    const __m128 offsets = _mm_setr_ps(offset.x(), offset.y(), offset.z(), 0.0F);
+    const __m128i magnitudeMask = _mm_set1_epi32(0x7FFFFFFF);
+    const __m128i signMask = _mm_set1_epi32(0x8000);
+    const __m128i oneBit = _mm_set1_epi32(1);
+    const __m128i halfMask = _mm_set1_epi32(0xFFFF);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (const auto& position : positions) {
+        const __m128i bits =
+            _mm_castps_si128(_mm_sub_ps(_mm_setr_ps(position.x(), position.y(), position.z(), 0.0F), offsets));
+        const __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), signMask);
+        const __m128i magnitude = _mm_and_si128(bits, magnitudeMask);
+
+        // Too large becomes infinity, NaN a quiet NaN
+        const __m128i tooLarge = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x477FFFFF));
+        const __m128i isNaN = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7F800000));
+        const __m128i infinite = _mm_or_si128(
+            _mm_and_si128(isNaN, _mm_set1_epi32(0x7E00)), _mm_andnot_si128(isNaN, _mm_set1_epi32(0x7C00)));
+
+        // Too small rounds through the float adder, the rest rebias and round to nearest even
+        const __m128i tooSmall = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(0x38800000));
+        const __m128i subnormal = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_set1_ps(0.5F))),
+            _mm_set1_epi32(0x3F000000));
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), oneBit);
+        const __m128i normal = _mm_srli_epi32(
+            _mm_add_epi32(_mm_add_epi32(magnitude, _mm_set1_epi32(static_cast<int>(0xC8000FFFU))), odd), 13);
+
+        __m128i half = _mm_or_si128(_mm_and_si128(tooSmall, subnormal), _mm_andnot_si128(tooSmall, normal));
+        half = _mm_or_si128(_mm_and_si128(tooLarge, infinite), _mm_andnot_si128(tooLarge, half));
+        half = _mm_or_si128(_mm_and_si128(half, halfMask), sign);
+
+        // SSE2 only packs signed, so bias into the signed range and flip the top bit back afterwards
+        const __m128i integers = _mm_sub_epi32(half, bias);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_xor_si128(_mm_packs_epi32(integers, integers), flip));
+        out += 4U;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// quantize_unorm16_positions
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_unorm16_positions(
+    const std::vector<vec3>& positions, const vec3& offset, const vec3& invScale, uint16_t* out) noexcept {
+    const __m128 offsets = _mm_setr_ps(offset.x(), offset.y(), offset.z(), 0.0F);
+    const __m128 scales = _mm_setr_ps(invScale.x(), invScale.y(), invScale.z(), 0.0F);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 range = _mm_set1_ps(Unorm16Max);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (const auto& position : positions) {
+        // One vertex per register, loading lane by lane so the last vertex never reads past the end
+        __m128 value = _mm_setr_ps(position.x(), position.y(), position.z(), 0.0F);
+        value = _mm_mul_ps(_mm_sub_ps(value, offsets), scales);
+        value = _mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), range);
+
+        // SSE2 only packs signed, so bias into the signed range and flip the top bit back afterwards
+        const __m128i integers = _mm_sub_epi32(_mm_cvtps_epi32(value), bias);
+        const __m128i packed = _mm_xor_si128(_mm_packs_epi32(integers, integers), flip);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+        out += 4U;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// encode_octahedral
+//////////////////////////////////////////////////////////////////////
+
+static void encode_octahedral(const std::vector<vec3>& normals, uint32_t* out) noexcept {
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 range = _mm_set1_ps(Snorm16Max);
+    for (const auto& normal : normals) {
+        const __m128 value = _mm_setr_ps(normal.x(), normal.y(), normal.z(), 0.0F);
+
+        // Broadcast the L1 norm to every lane, then project onto the octahedron
+        __m128 sum = _mm_andnot_ps(signMask, value);
+        sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        const __m128 valid = _mm_cmpgt_ps(sum, _mm_setzero_ps());
+        const __m128 projected = _mm_and_ps(_mm_div_ps(value, _mm_or_ps(sum, _mm_andnot_ps(valid, one))), valid);
+
+        // Fold the lower hemisphere into the corners, keeping each lane's sign
+        const __m128 magnitude = _mm_andnot_ps(signMask, projected);
+        const __m128 swapped = _mm_shuffle_ps(magnitude, magnitude, _MM_SHUFFLE(3, 2, 0, 1));
+        const __m128 folded = _mm_or_ps(_mm_sub_ps(one, swapped), _mm_and_ps(projected, signMask));
+        const __m128 below = _mm_cmplt_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2)), _mm_setzero_ps());
+        __m128 result = _mm_or_ps(_mm_and_ps(below, folded), _mm_andnot_ps(below, projected));
+
+        result = _mm_mul_ps(_mm_min_ps(_mm_max_ps(result, _mm_sub_ps(_mm_setzero_ps(), one)), one), range);
+        const __m128i integers = _mm_cvtps_epi32(result);
+        *out++ = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packs_epi32(integers, integers)));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// quantize_uvs
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_uvs(const std::vector<vec2>& uvs, uint32_t* out) noexcept {
+    static_assert(sizeof(vec2) == sizeof(float) * 2U, "vec2 must be tightly packed");
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 range = _mm_set1_ps(Unorm16Max);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    size_t x = 0;
+    for (; x + 2U <= uvs.size(); x += 2U) {
+        // Two coordinates per register
+        __m128 value = _mm_loadu_ps(uvs[x].data());
+        value = _mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), range);
+        const __m128i integers = _mm_sub_epi32(_mm_cvtps_epi32(value), bias);
+        const __m128i packed = _mm_xor_si128(_mm_packs_epi32(integers, integers), flip);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x]), packed);
+    }
+    for (; x < uvs.size(); ++x)
+        out[x] = static_cast<uint32_t>(to_unorm16(uvs[x].x())) | (static_cast<uint32_t>(to_unorm16(uvs[x].y())) << 16U);
+}
+#else
+//////////////////////////////////////////////////////////////////////
+/// quantize_half_positions
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_half_positions(const std::vector<vec3>& positions, const vec3& offset, uint16_t* out) noexcept {
+    for (const auto& position : positions) {
+        const auto local = position - offset;
+        for (size_t axis = 0; axis < 3U; ++axis)
+            out[axis] = mini::FloatToHalf(local[axis]);
+        out[3] = 0U;
+        out += 4U;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// to_snorm16
+//////////////////////////////////////////////////////////////////////
+
+static int16_t to_snorm16(const float value) noexcept {
+    return static_cast<int16_t>(std::nearbyint(std::min(std::max(value, -1.0F), 1.0F) * Snorm16Max));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// octahedral_fold
+//////////////////////////////////////////////////////////////////////
+
+static vec2 octahedral_fold(const vec3& normal) noexcept {
+    const float length = std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z());
+    const float x = length > 0.0F ? normal.x() / length : 0.0F;
+    const float y = length > 0.0F ? normal.y() / length : 0.0F;
+    if (normal.z() >= 0.0F)
+        return vec2(x, y);
+
+    // Fold the lower hemisphere into the corners of the square
+    return vec2(
+        std::copysign(1.0F - std::abs(y), x), std::copysign(1.0F - std::abs(x), y));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// quantize_unorm16_positions
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_unorm16_positions(
+    const std::vector<vec3>& positions, const vec3& offset, const vec3& invScale, uint16_t* out) noexcept {
+    for (const auto& position : positions) {
+        for (size_t axis = 0; axis < 3U; ++axis)
+            out[axis] = to_unorm16((position[axis] - offset[axis]) * invScale[axis]);
+        out[3] = 0U;
+        out += 4U;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// encode_octahedral
+//////////////////////////////////////////////////////////////////////
+
+static void encode_octahedral(const std::vector<vec3>& normals, uint32_t* out) noexcept {
+    for (const auto& normal : normals) {
+        const auto folded = octahedral_fold(normal);
+        *out++ = static_cast<uint32_t>(static_cast<uint16_t>(to_snorm16(folded.x())))
+                 | (static_cast<uint32_t>(static_cast<uint16_t>(to_snorm16(folded.y()))) << 16U);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// quantize_uvs
+//////////////////////////////////////////////////////////////////////
+
+static void quantize_uvs(const std::vector<vec2>& uvs, uint32_t* out) noexcept {
+    for (size_t x = 0; x < uvs.size(); ++x)
+        out[x] = static_cast<uint32_t>(to_unorm16(uvs[x].x())) | (static_cast<uint32_t>(to_unorm16(uvs[x].y())) << 16U);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+/// accumulate_error
+//////////////////////////////////////////////////////////////////////
+
+static void accumulate_error(QuantizationError& error, const float value) noexcept {
+    error.maximum = std::max(error.maximum, value);
+    error.mean += value;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// finish_error
+//////////////////////////////////////////////////////////////////////
+
+static void finish_error(QuantizationError& error, const size_t count) noexcept {
+    if (count != 0U)
+        error.mean /= static_cast<float>(count);
+}
\ No newline at end of file
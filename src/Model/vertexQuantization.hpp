@@ -0,0 +1,101 @@
+#pragma once
+#ifndef MINIGFX_VERTEXQUANTIZATION_HPP
+#define MINIGFX_VERTEXQUANTIZATION_HPP
+
+#include "Utility/vec.hpp"
+#include <cstdint>
+#include <stddef.h>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  How vertex positions are stored on the GPU.
+enum class PositionEncoding {
+    Float32, ///< Three 32-bit floats, 12 bytes per vertex.
+    Half,    ///< Three 16-bit floats relative to the mesh centre, padded to 8 bytes per vertex.
+    Unorm16  ///< Three normalized 16-bit integers across the mesh bounds, padded to 8 bytes per vertex.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Quantized positions, decoded as offset + scale * attribute.
+struct QuantizedPositions {
+    PositionEncoding encoding = PositionEncoding::Unorm16; ///< How the values are encoded.
+    std::vector<uint16_t> data;                            ///< Four values per vertex, the last is padding.
+    vec3 offset = vec3(0.0F);                              ///< Added to each decoded attribute.
+    vec3 scale = vec3(1.0F);                               ///< Multiplies each decoded attribute.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  The error introduced by an encoding, in the units of the measured quantity.
+struct QuantizationError {
+    float maximum = 0.0F; ///< The largest error of any one value.
+    float mean = 0.0F;    ///< The average error across every value.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Convert a float to the nearest 16-bit float.
+/// \param  value   the value to convert.
+/// \return the value as a 16-bit float, saturating to infinity.
+uint16_t FloatToHalf(const float value) noexcept;
+//////////////////////////////////////////////////////////////////////
+/// \brief  Convert a 16-bit float to a float.
+/// \param  value   the 16-bit float to convert.
+/// \return the exact value as a float.
+float HalfToFloat(const uint16_t value) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Quantize positions, using SIMD where available.
+/// \param  positions   the positions to quantize.
+/// \param  encoding    Half or Unorm16, Float32 is treated as Unorm16.
+/// \return the quantized positions, with the offset and scale to decode them.
+QuantizedPositions QuantizePositions(const std::vector<vec3>& positions, const PositionEncoding encoding);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Decode one quantized position.
+/// \param  positions   the quantized positions.
+/// \param  index       the vertex to decode.
+/// \return the decoded position.
+vec3 DecodePosition(const QuantizedPositions& positions, const size_t index) noexcept;
+//////////////////////////////////////////////////////////////////////
+/// \brief  Encode unit normals as two octahedral snorm16 values each, using SIMD where available.
+/// \note   Bind as 2 x GL_SHORT normalized, then unfold the octahedron in the shader.
+/// \param  normals     the unit normals to encode.
+/// \return one packed value per normal, x in the low half.
+std::vector<uint32_t> EncodeOctahedralNormals(const std::vector<vec3>& normals);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Decode one octahedral normal.
+/// \param  encoded     the packed normal.
+/// \return the decoded unit normal.
+vec3 DecodeOctahedralNormal(const uint32_t encoded) noexcept;
+//////////////////////////////////////////////////////////////////////
+/// \brief  Quantize texture coordinates to two unorm16 values each, using SIMD where available.
+/// \note   Coordinates are clamped to [0, 1], bind as 2 x GL_UNSIGNED_SHORT normalized.
+/// \param  uvs         the texture coordinates to quantize.
+/// \return one packed value per coordinate, u in the low half.
+std::vector<uint32_t> QuantizeUVs(const std::vector<vec2>& uvs);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Decode one quantized texture coordinate.
+/// \param  encoded     the packed coordinate.
+/// \return the decoded coordinate.
+vec2 DecodeUV(const uint32_t encoded) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Measure how far quantized positions moved from the originals.
+/// \param  positions   the original positions.
+/// \param  quantized   the positions quantized from them.
+/// \return the distance error, in model units.
+QuantizationError MeasurePositionError(const std::vector<vec3>& positions, const QuantizedPositions& quantized);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Measure how far encoded normals turned from the originals.
+/// \param  normals     the original unit normals.
+/// \param  encoded     the normals encoded from them.
+/// \return the angular error, in degrees.
+QuantizationError MeasureNormalError(const std::vector<vec3>& normals, const std::vector<uint32_t>& encoded);
+//////////////////////////////////////////////////////////////////////
+/// \brief  Measure how far quantized texture coordinates moved from the originals.
+/// \param  uvs         the original texture coordinates.
+/// \param  encoded     the coordinates quantized from them.
+/// \return the distance error, in texture space.
+QuantizationError MeasureUVError(const std::vector<vec2>& uvs, const std::vector<uint32_t>& encoded);
+}; // namespace mini
+
+#endif // MINIGFX_VERTEXQUANTIZATION_HPP
\ No newline at end of file
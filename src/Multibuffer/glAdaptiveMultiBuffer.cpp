@@ -0,0 +1,198 @@
+#include "Multibuffer/glAdaptiveMultiBuffer.hpp"
+#include "Buffer/glFence.hpp"
+#include "Utility/memoryRegistry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::glAdaptiveMultiBuffer;
+using mini::glFence;
+using mini::MemoryRegistry;
+using Clock = std::chrono::steady_clock;
+constexpr auto MultiBufferCategory = MemoryRegistry::Category::MultiBuffer;
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Destructor
+//////////////////////////////////////////////////////////////////////
+
+glAdaptiveMultiBuffer::~glAdaptiveMultiBuffer() {
+    for (auto& slot : m_slots) {
+        glFence::WaitUntilSignaled(slot.writeFence, fenceSite());
+        glFence::WaitUntilSignaled(slot.readFence, fenceSite());
+        glUnmapNamedBuffer(slot.bufferID);
+        glDeleteBuffers(1, &slot.bufferID);
+        MemoryRegistry::Unmap(MultiBufferCategory);
+        MemoryRegistry::Free(MultiBufferCategory, m_size);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Custom Constructor
+//////////////////////////////////////////////////////////////////////
+
+glAdaptiveMultiBuffer::glAdaptiveMultiBuffer(const GLsizeiptr& size, const int slotCount, const GLbitfield& mapFlags)
+    : m_size(size), m_mapFlags(mapFlags) {
+    setSlotCount(slotCount);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// operator=
+//////////////////////////////////////////////////////////////////////
+
+glAdaptiveMultiBuffer& glAdaptiveMultiBuffer::operator=(glAdaptiveMultiBuffer&& other) noexcept {
+    if (&other != this) {
+        // Swap, so the other buffer releases any slots this one held
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_index, other.m_index);
+        std::swap(m_size, other.m_size);
+        std::swap(m_mapFlags, other.m_mapFlags);
+        std::swap(m_policy, other.m_policy);
+        std::swap(m_windowCount, other.m_windowCount);
+        std::swap(m_windowTotalNs, other.m_windowTotalNs);
+        std::swap(m_windowMaxNs, other.m_windowMaxNs);
+        std::swap(m_lastAverageNs, other.m_lastAverageNs);
+        std::swap(m_retired, other.m_retired);
+        std::swap(m_fenceSite, other.m_fenceSite);
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// beginWriting
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::beginWriting() {
+    m_retired.collect();
+    if (m_slots.empty())
+        return;
+
+    // Ensure all reads and writes at this index have finished, timing the stall
+    const auto start = Clock::now();
+    auto& slot = m_slots[m_index];
+    glFence::WaitUntilSignaled(slot.writeFence, fenceSite());
+    glFence::WaitUntilSignaled(slot.readFence, fenceSite());
+    if (m_policy.enabled)
+        adapt(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// write
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept {
+    auto& slot = m_slots[m_index];
+    std::memcpy(static_cast<unsigned char*>(slot.pointer) + offset, data, size);
+    if ((m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U)
+        slot.dirty.add(offset, size);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// endWriting
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::endWriting() noexcept {
+    if (m_slots.empty())
+        return;
+    auto& slot = m_slots[m_index];
+    slot.dirty.flush(slot.bufferID);
+    if (!slot.writeFence)
+        slot.writeFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// endReading
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::endReading() noexcept {
+    if (m_slots.empty())
+        return;
+    auto& slot = m_slots[m_index];
+    if (!slot.readFence)
+        slot.readFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_index = (m_index + 1) % m_slots.size();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// setSlotCount
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::setSlotCount(const int slotCount) {
+    const auto target = static_cast<size_t>(std::max(slotCount, 1));
+
+    // New slots go right after the current one, so they're the next to be written
+    while (m_slots.size() < target) {
+        auto slot = createSlot();
+        if (!m_slots.empty()) {
+            auto& current = m_slots[m_index];
+            current.dirty.flush(current.bufferID);
+            glCopyNamedBufferSubData(current.bufferID, slot.bufferID, 0, 0, m_size);
+
+            // The copy lands in the slot's mapped storage, so it must finish before the slot is written
+            slot.writeFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        const auto position = m_slots.empty() ? 0U : m_index + 1U;
+        m_slots.insert(m_slots.begin() + static_cast<std::ptrdiff_t>(position), std::move(slot));
+    }
+
+    // The slot after the current one was read longest ago, so remove it first
+    while (m_slots.size() > target) {
+        const auto position = (m_index + 1U) % m_slots.size();
+        auto& slot = m_slots[position];
+
+        // The retirement fence follows every prior use of the slot
+        glDeleteSync(slot.writeFence);
+        glDeleteSync(slot.readFence);
+        glUnmapNamedBuffer(slot.bufferID);
+        m_retired.retire(slot.bufferID, 0, MultiBufferCategory, m_size);
+        MemoryRegistry::Unmap(MultiBufferCategory);
+
+        m_slots.erase(m_slots.begin() + static_cast<std::ptrdiff_t>(position));
+        if (position < m_index)
+            --m_index;
+    }
+
+    m_windowCount = 0U;
+    m_windowTotalNs = 0U;
+    m_windowMaxNs = 0U;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// createSlot
+//////////////////////////////////////////////////////////////////////
+
+glAdaptiveMultiBuffer::Slot glAdaptiveMultiBuffer::createSlot() const {
+    Slot slot;
+    glCreateBuffers(1, &slot.bufferID);
+    glNamedBufferStorage(
+        slot.bufferID, m_size, nullptr, GL_DYNAMIC_STORAGE_BIT | StorageFlagsFromMapFlags(m_mapFlags));
+    slot.pointer = glMapNamedBufferRange(slot.bufferID, 0, m_size, m_mapFlags);
+    MemoryRegistry::Allocate(MultiBufferCategory, m_size);
+    MemoryRegistry::Map(MultiBufferCategory);
+    return slot;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// adapt
+//////////////////////////////////////////////////////////////////////
+
+void glAdaptiveMultiBuffer::adapt(const uint64_t stallNs) {
+    ++m_windowCount;
+    m_windowTotalNs += stallNs;
+    m_windowMaxNs = std::max(m_windowMaxNs, stallNs);
+    if (m_windowCount < std::max(m_policy.windowFrames, 1U))
+        return;
+
+    // Stalling means the GPU is still reading the slot we cycled back to, so add depth.
+    // A window without any real stall means a slot can go, buying back latency and memory.
+    m_lastAverageNs = m_windowTotalNs / m_windowCount;
+    const auto slots = slotCount();
+    if (m_lastAverageNs > m_policy.raiseAverageNs && slots < m_policy.maxSlots)
+        setSlotCount(slots + 1);
+    else if (m_windowMaxNs < m_policy.lowerMaximumNs && slots > m_policy.minSlots)
+        setSlotCount(slots - 1);
+    else
+        setSlotCount(std::clamp(slots, m_policy.minSlots, std::max(m_policy.minSlots, m_policy.maxSlots)));
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#ifndef MINIGFX_GLADAPTIVEMULTIBUFFER_HPP
+#define MINIGFX_GLADAPTIVEMULTIBUFFER_HPP
+
+#include "Buffer/glDirtyRanges.hpp"
+#include "Buffer/glFence.hpp"
+#include "Buffer/glReadback.hpp"
+#include "Buffer/glRetirementQueue.hpp"
+#include <cstdint>
+#include <glad/glad.h>
+#include <utility>
+#include <vector>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  glAdaptiveMultiBuffer
+/// \brief  A fixed-size OpenGL multi-buffer whose slot count is chosen at runtime,
+///         optionally adapting it to the fence stalls measured in beginWriting().
+class glAdaptiveMultiBuffer {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Controls when the slot count is raised or lowered.
+    struct AdaptivePolicy {
+        bool enabled = true;                 ///< Whether to adapt the slot count at all.
+        int minSlots = 2;                    ///< Never use fewer slots than this.
+        int maxSlots = 4;                    ///< Never use more slots than this.
+        unsigned int windowFrames = 120U;    ///< Number of beginWriting() calls per decision.
+        uint64_t raiseAverageNs = 250000U;   ///< Add a slot if the average stall exceeds this.
+        uint64_t lowerMaximumNs = 20000U;    ///< Drop a slot if no stall in a window exceeded this.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for all fences to complete, then destroy this buffer.
+    ~glAdaptiveMultiBuffer();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a new adaptive multi-buffer.
+    /// \param  size        the byte-size of each slot.
+    /// \param  slotCount   the starting number of slots.
+    /// \param  mapFlags    map flags, use ExplicitFlushMapFlags for a non-coherent mapping.
+    explicit glAdaptiveMultiBuffer(
+        const GLsizeiptr& size, const int slotCount = 3,
+        const GLbitfield& mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Move constructor.
+    /// \param  other   another buffer to move from.
+    glAdaptiveMultiBuffer(glAdaptiveMultiBuffer&& other) noexcept { (*this) = std::move(other); }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Movement operator, for moving another buffer into this one.
+    /// \param  other   another buffer to move the data from, to here.
+    glAdaptiveMultiBuffer& operator=(glAdaptiveMultiBuffer&& other) noexcept;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Prepare the current slot for writing, waiting on any reads.
+    /// \note   The time spent waiting drives the adaptive slot count.
+    void beginWriting();
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write the supplied data into the current slot.
+    /// \param  offset      byte offset from the beginning.
+    /// \param  size        the size of the data to write.
+    /// \param  data        the data to write.
+    void write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Signal that the current slot is finished being written to.
+    void endWriting() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Signal that the current slot is finished being read from, advancing to the next.
+    void endReading() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Change the number of slots.
+    /// \note   New slots start as GPU copies of the current one, removed slots are retired without stalling.
+    /// \param  slotCount   the new number of slots, at least 1.
+    void setSlotCount(const int slotCount);
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the current number of slots.
+    /// \return the slot count.
+    int slotCount() const noexcept { return static_cast<int>(m_slots.size()); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Replace the policy that adapts the slot count.
+    /// \param  policy      the new policy.
+    void setAdaptivePolicy(const AdaptivePolicy& policy) noexcept { m_policy = policy; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the average stall of the last completed decision window.
+    /// \return the average stall in nanoseconds.
+    uint64_t averageStallNs() const noexcept { return m_lastAverageNs; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Name the call site this buffer's fence stalls are recorded under.
+    /// \param  site    the call site name.
+    void setFenceSite(const char* site) { m_fenceSite = &glFence::FindSite(site); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the call site this buffer's fence stalls are recorded under.
+    /// \return reference to the call site.
+    glFence::Site& fenceSite() const noexcept {
+        static auto& s_default = glFence::FindSite("glAdaptiveMultiBuffer");
+        return m_fenceSite != nullptr ? *m_fenceSite : s_default;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind the current slot to the target specified.
+    /// \param  target  the target type of this buffer.
+    void bindBuffer(const GLenum target) const noexcept { glBindBuffer(target, bufferID()); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Bind the current slot to a particular shader binding point.
+    /// \param  target  the target type of this buffer.
+    /// \param  index   the binding point index to use.
+    void bindBufferBase(const GLenum target, const GLuint index) const noexcept {
+        glBindBufferBase(target, index, bufferID());
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the OpenGL object ID of the current slot.
+    /// \return the buffer ID.
+    GLuint bufferID() const noexcept { return m_slots.empty() ? 0U : m_slots[m_index].bufferID; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Begin copying a range of the current slot back to the CPU, without stalling.
+    /// \param  offset  byte offset from the beginning.
+    /// \param  size    the number of bytes to read.
+    /// \return a handle to poll or wait on for the data.
+    glReadback readAsync(const GLintptr offset, const GLsizeiptr size) const {
+        return glReadback::Read(bufferID(), offset, size);
+    }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy constructor.
+    glAdaptiveMultiBuffer(const glAdaptiveMultiBuffer&) = delete;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Deleted copy-assignment operator.
+    glAdaptiveMultiBuffer& operator=(const glAdaptiveMultiBuffer&) = delete;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  One persistently mapped copy of the buffer.
+    struct Slot {
+        GLuint bufferID = 0;         ///< OpenGL object ID.
+        void* pointer = nullptr;     ///< Persistent mapping of the buffer.
+        GLsync writeFence = nullptr; ///< Fence for writing data.
+        GLsync readFence = nullptr;  ///< Fence for reading data.
+        glDirtyRanges dirty;         ///< Ranges awaiting an explicit flush.
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Create and map a new slot.
+    /// \return the new slot.
+    Slot createSlot() const;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Feed one measured stall into the adaptive policy.
+    /// \param  stallNs     how long beginWriting() waited.
+    void adapt(const uint64_t stallNs);
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<Slot> m_slots;                         ///< Every slot, in ring order.
+    size_t m_index = 0;                                ///< The current slot.
+    GLsizeiptr m_size = 0;                             ///< Byte-size of each slot.
+    GLbitfield m_mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                            GL_MAP_COHERENT_BIT;       ///< OpenGL map storage flags.
+    AdaptivePolicy m_policy;                           ///< When to change the slot count.
+    unsigned int m_windowCount = 0U;                   ///< Stalls measured in the current window.
+    uint64_t m_windowTotalNs = 0U;                     ///< Total stall in the current window.
+    uint64_t m_windowMaxNs = 0U;                       ///< Longest stall in the current window.
+    uint64_t m_lastAverageNs = 0U;                     ///< Average stall of the last window.
+    glRetirementQueue m_retired;                       ///< Removed slots the GPU may still use.
+    glFence::Site* m_fenceSite = nullptr;              ///< Site fence stalls are recorded under, the default if null.
+};
+}; // namespace mini
+
+#endif // MINIGFX_GLADAPTIVEMULTIBUFFER_HPP
\ No newline at end of file
@@ -2,7 +2,9 @@
 #ifndef MINIGFX_GLDYNAMICMULTIBUFFER_HPP
 #define MINIGFX_GLDYNAMICMULTIBUFFER_HPP
 
+#include "Buffer/glReservations.hpp"
 #include "Multibuffer/glMultiBuffer.hpp"
+#include "Utility/memoryRegistry.hpp"
 #include <cstring>
 #include <memory>
 #include <utility>
@@ -22,6 +24,8 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
             if (this->m_bufferID[x]) {
                 glUnmapNamedBuffer(this->m_bufferID[x]);
                 glDeleteBuffers(1, &this->m_bufferID[x]);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::MultiBuffer);
+                MemoryRegistry::Free(MemoryRegistry::Category::MultiBuffer, m_maxCapacity);
             }
         }
     }
@@ -38,6 +42,8 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
         for (int x = 0; x < BufferCount; ++x) {
             glNamedBufferStorage(this->m_bufferID[x], m_maxCapacity, data, GL_DYNAMIC_STORAGE_BIT | m_mapFlags);
             m_bufferPtr[x] = glMapNamedBufferRange(this->m_bufferID[x], 0, m_maxCapacity, m_mapFlags);
+            MemoryRegistry::Allocate(MemoryRegistry::Category::MultiBuffer, m_maxCapacity);
+            MemoryRegistry::Map(MemoryRegistry::Category::MultiBuffer);
         }
     }
     //////////////////////////////////////////////////////////////////////
@@ -71,6 +77,8 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
         m_mapFlags = (std::move(other.m_mapFlags));
         m_maxCapacity = (std::move(other.m_maxCapacity));
         this->m_index = std::move(other.m_index);
+        this->m_fenceSite = other.m_fenceSite;
+        m_reservations = std::move(other.m_reservations);
         other.m_mapFlags = 0;
         other.m_maxCapacity = 0;
         other.m_index = 0;
@@ -112,6 +120,40 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
             glNamedBufferSubData(buffer, offset, size, data);
     }
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Start handing out byte ranges of the current slot to reserve(), from the offset provided.
+    /// \note   Call from the GL thread, after beginWriting() and before any worker reserves.
+    /// \param  offset      byte offset the first reservation starts at.
+    void beginReservations(const GLsizeiptr offset = 0) noexcept {
+        m_reservations.begin(m_bufferPtr[this->m_index], m_maxCapacity, offset);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve a writable byte range of the current slot, safe to call from any thread at once.
+    /// \note   Never grows the buffer, ranges past its end are written to CPU memory until committed.
+    /// \param  size        the byte-size of the range.
+    /// \param  alignment   the alignment of the range's offset, a power of two.
+    /// \return the reserved range, writable until commitReservations().
+    glReservations::Reservation reserve(const GLsizeiptr size, const GLsizeiptr alignment = 16) {
+        return m_reservations.reserve(size, alignment);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Grow this buffer to fit every reservation, copying any that overflowed into the current slot.
+    /// \note   Call from the GL thread, once every worker has finished writing.
+    /// \return the end of the last reservation, in bytes.
+    GLsizeiptr commitReservations() noexcept {
+        const auto end = m_reservations.end();
+        const auto capacity = m_maxCapacity;
+        expandToFit(0, end);
+
+        // Growing copies the old contents on the GPU, which must land before the overflow is written past them
+        if (m_maxCapacity != capacity) {
+            GLsync copied = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            this->WaitForFence(copied, this->fenceSite());
+        }
+        m_reservations.commit(m_bufferPtr[this->m_index]);
+        m_reservations.begin(m_bufferPtr[this->m_index], m_maxCapacity, end);
+        return end;
+    }
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Expands this buffer's container to fit the desired range.
     /// \note   May invalidate the previous underlying data range.
     /// \param  offset      byte offset from the  beginning.
@@ -144,6 +186,10 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
                 // Migrate new buffer
                 this->m_bufferID[x] = newBuffer;
                 m_bufferPtr[x] = glMapNamedBufferRange(this->m_bufferID[x], 0, m_maxCapacity, m_mapFlags);
+                MemoryRegistry::Reallocate(MemoryRegistry::Category::MultiBuffer, m_maxCapacity, oldSize);
+                MemoryRegistry::Free(MemoryRegistry::Category::MultiBuffer, oldSize);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::MultiBuffer);
+                MemoryRegistry::Map(MemoryRegistry::Category::MultiBuffer);
             }
         }
     }
@@ -155,6 +201,7 @@ template <int BufferCount = 3> class glDynamicMultiBuffer final : public glMulti
     GLbitfield m_mapFlags =
         GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
     void* m_bufferPtr[BufferCount]{};                                   ///< Pointer to underlying buffer data.
+    glReservations m_reservations;                                      ///< Ranges handed out to workers.
 };
 }; // namespace mini
 
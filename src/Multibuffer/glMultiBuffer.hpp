@@ -2,6 +2,8 @@
 #ifndef MINIGFX_GLMULTIBUFFER_HPP
 #define MINIGFX_GLMULTIBUFFER_HPP
 
+#include "Buffer/glFence.hpp"
+#include "Buffer/glReadback.hpp"
 #include <glad/glad.h>
 
 namespace mini {
@@ -31,27 +33,26 @@ template <int BufferCount = 3> class glMultiBuffer {
     glMultiBuffer& operator=(const glMultiBuffer&) noexcept = default;
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Wait for the fence at the supplied index to pass.
-    /// \param fence the fence belonging to a particular internal buffer.
-    static void WaitForFence(GLsync& fence) noexcept {
-        while (fence) {
-            GLbitfield waitFlags = 0;
-            if (const auto waitReturn = glClientWaitSync(fence, waitFlags, 1); waitReturn == GL_SIGNALED ||
-                                                                               waitReturn == GL_ALREADY_SIGNALED ||
-                                                                               waitReturn == GL_CONDITION_SATISFIED) {
-                glDeleteSync(fence);
-                fence = nullptr;
-                return;
-            }
-            waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
-        }
+    /// \brief  Retrieve the call site every glMultiBuffer records under unless given its own.
+    /// \return reference to the default call site.
+    static glFence::Site& DefaultFenceSite() {
+        static auto& s_site = glFence::FindSite("glMultiBuffer");
+        return s_site;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for a fence to pass, however long it takes.
+    /// \note   Timeouts are recorded against the site and the wait carries on, as the caller is about to write.
+    /// \param  fence   the fence belonging to a particular internal buffer.
+    /// \param  site    the call site to attribute any stall to.
+    static void WaitForFence(GLsync& fence, glFence::Site& site = DefaultFenceSite()) noexcept {
+        glFence::WaitUntilSignaled(fence, site);
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Prepare this buffer for writing, waiting on any reads.
     void beginWriting() const noexcept {
         // Ensure all reads and writes at this index have finished.
-        WaitForFence(m_writeFence[m_index]);
-        WaitForFence(m_readFence[m_index]);
+        WaitForFence(m_writeFence[m_index], fenceSite());
+        WaitForFence(m_readFence[m_index], fenceSite());
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Signal that this multi-buffer is finished being written to.
@@ -67,6 +68,14 @@ template <int BufferCount = 3> class glMultiBuffer {
         m_index = (m_index + 1) % BufferCount;
     }
     //////////////////////////////////////////////////////////////////////
+    /// \brief  Name the call site this buffer's fence stalls are recorded under.
+    /// \param  site    the call site name.
+    void setFenceSite(const char* site) { m_fenceSite = &glFence::FindSite(site); }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the call site this buffer's fence stalls are recorded under.
+    /// \return reference to the call site.
+    glFence::Site& fenceSite() const noexcept { return m_fenceSite != nullptr ? *m_fenceSite : DefaultFenceSite(); }
+    //////////////////////////////////////////////////////////////////////
     /// \brief  Bind this buffer to the target specified.
     /// \param  target  the target type of this buffer.
     void bindBuffer(const GLenum target) const noexcept { glBindBuffer(target, m_bufferID[m_index]); }
@@ -77,6 +86,18 @@ template <int BufferCount = 3> class glMultiBuffer {
     void bindBufferBase(const GLenum target, const GLuint index) const noexcept {
         glBindBufferBase(target, index, m_bufferID[m_index]);
     }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the OpenGL object ID of the current internal buffer.
+    /// \return the buffer ID.
+    GLuint bufferID() const noexcept { return m_bufferID[m_index]; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Begin copying a range of the current internal buffer back to the CPU, without stalling.
+    /// \param  offset  byte offset from the beginning.
+    /// \param  size    the number of bytes to read.
+    /// \return a handle to poll or wait on for the data.
+    glReadback readAsync(const GLintptr offset, const GLsizeiptr size) const {
+        return glReadback::Read(m_bufferID[m_index], offset, size);
+    }
 
     protected:
     //////////////////////////////////////////////////////////////////////
@@ -85,6 +106,7 @@ template <int BufferCount = 3> class glMultiBuffer {
     mutable GLsync m_readFence[BufferCount]{};  ///< Fence for reading data.
     GLuint m_bufferID[BufferCount]{};           ///< OpenGL object IDs.
     int m_index = 0;                            ///< Multi-buffer index.
+    glFence::Site* m_fenceSite = nullptr;       ///< Site fence stalls are recorded under, the default if null.
 };
 }; // namespace mini
 
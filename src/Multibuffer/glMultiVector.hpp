@@ -3,46 +3,58 @@
 #define MINIGFX_GLMULTIVECTOR_HPP
 
 #include "Multibuffer/glMultiBuffer.hpp"
+#include "Utility/memoryRegistry.hpp"
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mini {
 //////////////////////////////////////////////////////////////////////
 /// \class  glMultiVector
 /// \brief  An STL-like vector for OpenGL multi-buffered data.
+/// \note   Elements live in a CPU shadow copy. Each slot only receives the elements
+///         changed since it was last written, replayed when it is next written.
 /// \tparam T   the type of element to construct an array of.
 template <typename T, int BufferCount = 3> class glMultiVector final : public glMultiBuffer<BufferCount> {
+    static_assert(std::is_trivially_copyable<T>::value, "elements are copied into mapped memory");
+    static_assert(BufferCount > 0 && BufferCount <= 8, "stale slots are tracked in an 8-bit mask");
+
     public:
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy this GL Vector.
     ~glMultiVector() {
         // Safely destroy each buffer this class owns
         for (int x = 0; x < BufferCount; ++x) {
-            WaitForFence(m_writeFence[x]);
-            WaitForFence(m_readFence[x]);
-            if (m_bufferID[x]) {
-                glUnmapNamedBuffer(m_bufferID[x]);
-                glDeleteBuffers(1, &m_bufferID[x]);
+            this->WaitForFence(this->m_writeFence[x]);
+            this->WaitForFence(this->m_readFence[x]);
+            if (this->m_bufferID[x]) {
+                glUnmapNamedBuffer(this->m_bufferID[x]);
+                glDeleteBuffers(1, &this->m_bufferID[x]);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::MultiBuffer);
+                MemoryRegistry::Free(MemoryRegistry::Category::MultiBuffer, sizeof(T) * m_capacity);
             }
         }
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Construct a GL Vector.
     /// \param  capacity    the starting capacity(1 or more).
-    glMultiVector(const size_t& capacity = 1) : m_capacity(std::max(1ull, capacity)) {
-        // Zero-initialize our starting variables
-        for (int x = 0; x < BufferCount; ++x) {
-            m_bufferID[x] = 0;
-            m_bufferPtr[x] = nullptr;
-            m_writeFence[x] = nullptr;
-            m_readFence[x] = nullptr;
-        }
-
+    glMultiVector(const size_t& capacity = 1)
+        : m_capacity(std::max<size_t>(1U, capacity)), m_shadow(m_capacity), m_stale(m_capacity, AllSlots) {
         // Create 'BufferCount' number of buffers & map them
-        const auto bufferSize = sizeof(T) * m_capacity;
-        glCreateBuffers(BufferCount, m_bufferID);
+        const auto bufferSize = static_cast<GLsizeiptr>(sizeof(T) * m_capacity);
+        glCreateBuffers(BufferCount, this->m_bufferID);
         for (int x = 0; x < BufferCount; ++x) {
-            glNamedBufferStorage(m_bufferID[x], bufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT | BufferFlags);
-            m_bufferPtr[x] = static_cast<T*>(glMapNamedBufferRange(m_bufferID[x], 0, bufferSize, BufferFlags));
+            glNamedBufferStorage(this->m_bufferID[x], bufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT | BufferFlags);
+            m_bufferPtr[x] = static_cast<T*>(glMapNamedBufferRange(this->m_bufferID[x], 0, bufferSize, BufferFlags));
+            MemoryRegistry::Allocate(MemoryRegistry::Category::MultiBuffer, bufferSize);
+            MemoryRegistry::Map(MemoryRegistry::Category::MultiBuffer);
+
+            // Every slot starts out stale, so the first write of each uploads the whole array
+            m_staleList[x].resize(m_capacity);
+            for (size_t index = 0; index < m_capacity; ++index)
+                m_staleList[x][index] = index;
         }
     }
     //////////////////////////////////////////////////////////////////////
@@ -52,84 +64,116 @@ template <typename T, int BufferCount = 3> class glMultiVector final : public gl
     //////////////////////////////////////////////////////////////////////
     /// \brief  Copy constructor.
     /// \param  other   another buffer to move the data from, to here.
-    glMultiVector(const glMultiVector& other) noexcept : glMultiVector(other.m_capacity) {
-        for (int x = 0; x < BufferCount; ++x)
-            glCopyNamedBufferSubData(other.m_bufferID[x], m_bufferID[x], 0, 0, m_capacity);
-    }
+    glMultiVector(const glMultiVector& other) : glMultiVector(other.m_capacity) { copy_from(other); }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Movement operator, for moving another buffer into this one.
     /// \param  other   another buffer to move the data from, to here.
     glMultiVector& operator=(glMultiVector&& other) noexcept {
-        for (int x = 0; x < BufferCount; ++x) {
-            m_bufferID[x] = std::move(other.m_bufferID[x]);
-            m_bufferPtr[x] = std::move(other.m_bufferPtr[x]);
-            m_writeFence[x] = std::move(other.m_writeFence[x]);
-            m_readFence[x] = std::move(other.m_readFence[x]);
-            other.m_bufferID[x] = 0;
-            other.m_bufferPtr[x] = nullptr;
-            other.m_writeFence[x] = nullptr;
-            other.m_readFence[x] = nullptr;
+        if (&other != this) {
+            // Swap, so the other vector releases any buffers this one held
+            for (int x = 0; x < BufferCount; ++x) {
+                std::swap(this->m_bufferID[x], other.m_bufferID[x]);
+                std::swap(m_bufferPtr[x], other.m_bufferPtr[x]);
+                std::swap(this->m_writeFence[x], other.m_writeFence[x]);
+                std::swap(this->m_readFence[x], other.m_readFence[x]);
+                std::swap(m_staleList[x], other.m_staleList[x]);
+            }
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_shadow, other.m_shadow);
+            std::swap(m_stale, other.m_stale);
+            std::swap(this->m_index, other.m_index);
+            std::swap(this->m_fenceSite, other.m_fenceSite);
         }
-
-        m_capacity = std::move(other.m_capacity);
-        m_index = std::move(other.m_index);
-        other.m_capacity = 0;
-        other.m_index = 0;
         return *this;
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Copy operator, for copying another buffer into this one.
     /// \param  other   another buffer to copy the data from, to here.
-    glMultiVector& operator=(const glMultiVector& other) noexcept {
-        m_capacity = other.m_capacity;
-        for (int x = 0; x < BufferCount; ++x)
-            glCopyNamedBufferSubData(other.m_bufferID[x], m_bufferID[x], 0, 0, m_capacity);
+    glMultiVector& operator=(const glMultiVector& other) {
+        if (&other != this) {
+            resize(other.m_capacity);
+            copy_from(other);
+        }
         return *this;
     }
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Retrieve a reference to the element at the index specified.
+    /// \brief  Retrieve a reference to the element at the index specified, marking it changed.
+    /// \note   The change reaches each slot the next time that slot is written.
+    /// \param  index   an index to the element desired.
+    /// \return reference to the element desired.
+    T& operator[](const size_t index) noexcept {
+        mark_stale(index, 1U);
+        return m_shadow[index];
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a read-only reference to the element at the index specified.
     /// \param  index   an index to the element desired.
     /// \return reference to the element desired.
-    T& operator[](const size_t index) noexcept { return m_bufferPtr[m_index][index]; }
+    const T& operator[](const size_t index) const noexcept { return m_shadow[index]; }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Overwrite a run of elements, marking them changed.
+    /// \param  first   index of the first element to overwrite.
+    /// \param  count   number of elements to overwrite.
+    /// \param  data    the new elements.
+    void write(const size_t first, const size_t count, const T* data) noexcept {
+        std::copy(data, data + count, m_shadow.begin() + static_cast<std::ptrdiff_t>(first));
+        mark_stale(first, count);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Signal that this multi-buffer is finished being written to.
+    /// \note   Replays every element changed since the current slot was last written.
+    void endWriting() noexcept {
+        replay(this->m_index);
+        glMultiBuffer<BufferCount>::endWriting();
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve how many elements the current slot has yet to receive.
+    /// \return the number of stale elements.
+    size_t staleCount() const noexcept { return m_staleList[this->m_index].size(); }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Resizes the internal capacity of this vector.
     /// \note   Does nothing if the capacity is the same
     /// \note   Currently, only grows, never shrinks
-    /// \note   May stall waiting for old buffers to finish, invalidate them.
+    /// \note   Never stalls, every slot is refilled from the shadow copy when next written.
     /// \param	newCapacity		the new desired capacity.
-    void resize(const size_t newCapacity) noexcept {
+    void resize(const size_t newCapacity) {
         // See if we must expand this container
         if (newCapacity > m_capacity) {
             // Calculate old and new byte sizes
-            const auto oldByteSize = sizeof(T) * m_capacity;
-            const auto newByteSize = sizeof(T) * newCapacity;
+            const auto oldByteSize = static_cast<GLsizeiptr>(sizeof(T) * m_capacity);
+            const auto newByteSize = static_cast<GLsizeiptr>(sizeof(T) * newCapacity);
             m_capacity = newCapacity;
+            m_shadow.resize(m_capacity);
+            m_stale.resize(m_capacity, 0U);
 
-            // Wait for and transfer data from old buffers into new buffers
-            // of the new size
+            // Replace each slot's buffer, the GL keeps the old ones alive for any draws still reading them
             for (int x = 0; x < BufferCount; ++x) {
-                WaitForFence(m_writeFence[x]);
-                WaitForFence(m_readFence[x]);
-
                 // Create new buffer
                 GLuint newBuffer = 0;
                 glCreateBuffers(1, &newBuffer);
                 glNamedBufferStorage(newBuffer, newByteSize, nullptr, GL_DYNAMIC_STORAGE_BIT | BufferFlags);
 
-                // Copy old buffer
-                if (oldByteSize)
-                    glCopyNamedBufferSubData(m_bufferID[x], newBuffer, 0, 0, oldByteSize);
-
-                // Delete old buffer
-                glUnmapNamedBuffer(m_bufferID[x]);
-                glDeleteBuffers(1, &m_bufferID[x]);
+                // Delete old buffer, its fences guard nothing in the new one
+                glDeleteSync(this->m_writeFence[x]);
+                glDeleteSync(this->m_readFence[x]);
+                this->m_writeFence[x] = nullptr;
+                this->m_readFence[x] = nullptr;
+                glUnmapNamedBuffer(this->m_bufferID[x]);
+                glDeleteBuffers(1, &this->m_bufferID[x]);
 
                 // Migrate new buffer
-                m_bufferID[x] = newBuffer;
-                m_bufferPtr[x] = (T*)(glMapNamedBufferRange(m_bufferID[x], 0, newByteSize, BufferFlags));
+                this->m_bufferID[x] = newBuffer;
+                m_bufferPtr[x] = static_cast<T*>(glMapNamedBufferRange(newBuffer, 0, newByteSize, BufferFlags));
+                MemoryRegistry::Reallocate(MemoryRegistry::Category::MultiBuffer, newByteSize, 0);
+                MemoryRegistry::Free(MemoryRegistry::Category::MultiBuffer, oldByteSize);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::MultiBuffer);
+                MemoryRegistry::Map(MemoryRegistry::Category::MultiBuffer);
             }
+
+            // The shadow holds every element, so replaying it all refills the new storage without a GPU copy
+            mark_stale(0U, m_capacity);
         }
     }
     //////////////////////////////////////////////////////////////////////
@@ -138,12 +182,67 @@ template <typename T, int BufferCount = 3> class glMultiVector final : public gl
     size_t getLength() const noexcept { return m_capacity; }
 
     private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Flag a run of elements as out of date in every slot.
+    /// \param  first   index of the first element.
+    /// \param  count   number of elements.
+    void mark_stale(const size_t first, const size_t count) {
+        for (size_t index = first; index < first + count; ++index) {
+            auto& mask = m_stale[index];
+            if (mask == AllSlots)
+                continue;
+            for (int x = 0; x < BufferCount; ++x)
+                if ((mask & (1U << x)) == 0U)
+                    m_staleList[x].push_back(index);
+            mask = AllSlots;
+        }
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy every stale element of a slot from the shadow copy, in contiguous runs.
+    /// \param  slot    the slot to bring up to date.
+    void replay(const int slot) noexcept {
+        auto& list = m_staleList[slot];
+        if (list.empty())
+            return;
+
+        std::sort(list.begin(), list.end());
+        const auto copy_run = [&](const size_t first, const size_t last) {
+            std::memcpy(m_bufferPtr[slot] + first, m_shadow.data() + first, sizeof(T) * (last - first));
+        };
+        size_t runFirst = list.front();
+        size_t runLast = runFirst;
+        for (const auto index : list) {
+            if (index != runLast) {
+                copy_run(runFirst, runLast);
+                runFirst = index;
+            }
+            runLast = index + 1U;
+            m_stale[index] = static_cast<unsigned char>(m_stale[index] & ~(1U << slot));
+        }
+        copy_run(runFirst, runLast);
+        list.clear();
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Replace every element with those of another vector of no greater capacity.
+    /// \note   Elements past the end of the other vector are value-initialized.
+    /// \param  other   the vector to copy.
+    void copy_from(const glMultiVector& other) {
+        // The shadow must keep one element per unit of capacity, whatever the other vector's size
+        m_shadow.assign(other.m_shadow.cbegin(), other.m_shadow.cend());
+        m_shadow.resize(m_capacity);
+        mark_stale(0U, m_capacity);
+    }
+
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    size_t m_capacity = 0; ///< Byte-Capacity of this buffer.
+    size_t m_capacity = 0; ///< Element-Capacity of this buffer.
     constexpr const static GLbitfield BufferFlags =
-        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
-    T* m_bufferPtr[BufferCount]{};                                      /// < Pointer to buffer data.
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;    ///< OpenGL map storage flags.
+    constexpr const static unsigned char AllSlots = (1U << BufferCount) - 1U; ///< Stale mask of every slot.
+    T* m_bufferPtr[BufferCount]{};                                           ///< Pointer to buffer data.
+    std::vector<T> m_shadow;                                                 ///< Current value of every element.
+    std::vector<unsigned char> m_stale;                                      ///< Per element, slots it's stale in.
+    std::vector<size_t> m_staleList[BufferCount];                            ///< Per slot, its stale elements.
 };
 }; // namespace mini
 
@@ -2,7 +2,9 @@
 #ifndef MINIGFX_GLSTATICMULTIBUFFER_HPP
 #define MINIGFX_GLSTATICMULTIBUFFER_HPP
 
+#include "Buffer/glDirtyRanges.hpp"
 #include "Multibuffer/glMultiBuffer.hpp"
+#include "Utility/memoryRegistry.hpp"
 #include <cstring>
 #include <stddef.h>
 #include <utility>
@@ -17,11 +19,13 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     /// \brief  Wait on this buffers fences, then destroy it.
     ~glStaticMultiBuffer() {
         for (int x = 0; x < BufferCount; ++x) {
-            WaitForFence(m_writeFence[x]);
-            WaitForFence(m_readFence[x]);
-            if (m_bufferID[x]) {
-                glUnmapNamedBuffer(m_bufferID[x]);
-                glDeleteBuffers(1, &m_bufferID[x]);
+            this->WaitForFence(this->m_writeFence[x]);
+            this->WaitForFence(this->m_readFence[x]);
+            if (this->m_bufferID[x]) {
+                glUnmapNamedBuffer(this->m_bufferID[x]);
+                glDeleteBuffers(1, &this->m_bufferID[x]);
+                MemoryRegistry::Unmap(MemoryRegistry::Category::MultiBuffer);
+                MemoryRegistry::Free(MemoryRegistry::Category::MultiBuffer, static_cast<GLsizeiptr>(m_size));
             }
         }
     }
@@ -30,10 +34,10 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     glStaticMultiBuffer() {
         // Zero-initialize our starting variables
         for (int x = 0; x < BufferCount; ++x) {
-            m_bufferID[x] = 0;
+            this->m_bufferID[x] = 0;
             m_bufferPtr[x] = nullptr;
-            m_writeFence[x] = nullptr;
-            m_readFence[x] = nullptr;
+            this->m_writeFence[x] = nullptr;
+            this->m_readFence[x] = nullptr;
         }
     }
     //////////////////////////////////////////////////////////////////////
@@ -41,38 +45,34 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     /// \param  size            the starting size of this buffer.
     /// \param  data            optional data buffer, must be at least as large.
     /// \param  storageFlags    optional bit - field flags.
+    /// \param  mapFlags        map flags, use ExplicitFlushMapFlags for a non-coherent mapping.
     explicit glStaticMultiBuffer(
-        const GLsizeiptr& size, const void* data = nullptr, const GLbitfield storageFlags = GL_DYNAMIC_STORAGE_BIT)
-        : m_size(size) {
+        const GLsizeiptr& size, const void* data = nullptr, const GLbitfield storageFlags = GL_DYNAMIC_STORAGE_BIT,
+        const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+        : m_size(size), m_mapFlags(mapFlags) {
         // Zero-initialize our starting variables
         for (int x = 0; x < BufferCount; ++x) {
-            m_bufferID[x] = 0;
+            this->m_bufferID[x] = 0;
             m_bufferPtr[x] = nullptr;
-            m_writeFence[x] = nullptr;
-            m_readFence[x] = nullptr;
+            this->m_writeFence[x] = nullptr;
+            this->m_readFence[x] = nullptr;
         }
 
-        glCreateBuffers(BufferCount, m_bufferID);
+        glCreateBuffers(BufferCount, this->m_bufferID);
         for (int x = 0; x < BufferCount; ++x) {
-            glNamedBufferStorage(m_bufferID[x], m_size, data, storageFlags | m_mapFlags);
-            m_bufferPtr[x] = glMapNamedBufferRange(m_bufferID[x], 0, m_size, m_mapFlags);
-            if (data)
-                std::memcpy(static_cast<unsigned char*>(m_bufferPtr[x]), data, size);
+            glNamedBufferStorage(
+                this->m_bufferID[x], m_size, data, storageFlags | StorageFlagsFromMapFlags(m_mapFlags));
+            m_bufferPtr[x] = glMapNamedBufferRange(this->m_bufferID[x], 0, m_size, m_mapFlags);
+            MemoryRegistry::Allocate(MemoryRegistry::Category::MultiBuffer, static_cast<GLsizeiptr>(m_size));
+            MemoryRegistry::Map(MemoryRegistry::Category::MultiBuffer);
         }
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Construct a new Static Multi-Buffer, from another buffer.
-    glStaticMultiBuffer(const glStaticMultiBuffer& other) noexcept : glStaticMultiBuffer(other.m_size, 0) {
-        // Zero-initialize our starting variables
-        for (int x = 0; x < BufferCount; ++x) {
-            m_bufferID[x] = 0;
-            m_bufferPtr[x] = nullptr;
-            m_writeFence[x] = nullptr;
-            m_readFence[x] = nullptr;
-        }
-
+    glStaticMultiBuffer(const glStaticMultiBuffer& other) noexcept
+        : glStaticMultiBuffer(other.m_size, nullptr, GL_DYNAMIC_STORAGE_BIT, other.m_mapFlags) {
         for (int x = 0; x < BufferCount; ++x)
-            glCopyNamedBufferSubData(other.m_bufferID[x], m_bufferID[x], 0, 0, m_size);
+            glCopyNamedBufferSubData(other.m_bufferID[x], this->m_bufferID[x], 0, 0, m_size);
     }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Move Constructor.
@@ -85,7 +85,7 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
             m_size = other.m_size;
             m_mapFlags = other.m_mapFlags;
             for (int x = 0; x < BufferCount; ++x)
-                glCopyNamedBufferSubData(other.m_bufferID[x], m_bufferID[x], 0, 0, other.m_size);
+                glCopyNamedBufferSubData(other.m_bufferID[x], this->m_bufferID[x], 0, 0, other.m_size);
         }
         return *this;
     }
@@ -94,17 +94,19 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     glStaticMultiBuffer& operator=(glStaticMultiBuffer&& other) noexcept {
         if (this != &other) {
             for (int x = 0; x < BufferCount; ++x) {
-                m_bufferID[x] = std::move(other.m_bufferID[x]);
+                this->m_bufferID[x] = std::move(other.m_bufferID[x]);
                 m_bufferPtr[x] = std::move(other.m_bufferPtr[x]);
-                m_writeFence[x] = std::move(other.m_writeFence[x]);
-                m_readFence[x] = std::move(other.m_readFence[x]);
+                this->m_writeFence[x] = std::move(other.m_writeFence[x]);
+                this->m_readFence[x] = std::move(other.m_readFence[x]);
+                m_dirty[x] = std::move(other.m_dirty[x]);
                 other.m_bufferID[x] = 0;
                 other.m_bufferPtr[x] = nullptr;
                 other.m_writeFence[x] = nullptr;
                 other.m_readFence[x] = nullptr;
             }
             m_mapFlags = (std::move(other.m_mapFlags));
-            m_index = std::move(other.m_index);
+            this->m_index = std::move(other.m_index);
+            this->m_fenceSite = other.m_fenceSite;
             m_size = (std::move(other.m_size));
             other.m_mapFlags = 0;
             other.m_index = 0;
@@ -119,7 +121,16 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     /// \param  size        the size of the data to write.
     /// \param  data        the data to write.
     void write(const GLsizeiptr offset, const GLsizeiptr size, const void* data) noexcept {
-        std::memcpy(static_cast<unsigned char*>(m_bufferPtr[m_index]) + offset, data, size);
+        std::memcpy(static_cast<unsigned char*>(m_bufferPtr[this->m_index]) + offset, data, size);
+        if ((m_mapFlags & GL_MAP_FLUSH_EXPLICIT_BIT) != 0U)
+            m_dirty[this->m_index].add(offset, size);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Signal that this multi-buffer is finished being written to.
+    /// \note   Flushes the coalesced written ranges of a non-coherent mapping.
+    void endWriting() const noexcept {
+        m_dirty[this->m_index].flush(this->m_bufferID[this->m_index]);
+        glMultiBuffer<BufferCount>::endWriting();
     }
 
     private:
@@ -129,6 +140,7 @@ template <int BufferCount = 3> class glStaticMultiBuffer final : public glMultiB
     GLbitfield m_mapFlags =
         GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; ///< OpenGL map storage flags.
     void* m_bufferPtr[BufferCount]{};                                   ///< Pointer to buffer data.
+    mutable glDirtyRanges m_dirty[BufferCount];                         ///< Unflushed written ranges.
 };
 }; // namespace mini
 
@@ -2,8 +2,10 @@
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
+using mini::MemoryRegistry;
 using mini::Texture1D;
 constexpr auto MAX_ANISOTROPY = 16.0F;
+constexpr GLsizeiptr RGBA16F_TEXEL_BYTES = 8;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Constructor
@@ -14,6 +16,8 @@ Texture1D::Texture1D(
     // Create Texture & storage
     glCreateTextures(GL_TEXTURE_1D, 1, &m_glTexID);
     glTextureStorage1D(m_glTexID, 1, GL_RGBA16F, width);
+    m_storageBytes = static_cast<GLsizeiptr>(width) * RGBA16F_TEXEL_BYTES;
+    MemoryRegistry::Allocate(MemoryRegistry::Category::Texture, m_storageBytes);
 
     // Load Texture
     glTextureSubImage1D(m_glTexID, 0, 0, width, GL_RGBA, GL_FLOAT, pixelData);
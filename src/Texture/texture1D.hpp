@@ -2,7 +2,9 @@
 #ifndef MINIGFX_TEXTURE1D_HPP
 #define MINIGFX_TEXTURE1D_HPP
 
+#include "Utility/memoryRegistry.hpp"
 #include <glad/glad.h>
+#include <utility>
 
 namespace mini {
 //////////////////////////////////////////////////////////////////////
@@ -12,7 +14,11 @@ class Texture1D {
     public:
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy the Texture.
-    ~Texture1D() { glDeleteTextures(1, &m_glTexID); }
+    ~Texture1D() {
+        if (m_glTexID != 0U)
+            MemoryRegistry::Free(MemoryRegistry::Category::Texture, m_storageBytes);
+        glDeleteTextures(1, &m_glTexID);
+    }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Construct a Texture with a given size and data.
     /// \param  pixelData       the image pixels.
@@ -22,12 +28,18 @@ class Texture1D {
     /// \param  mipmap          whether to apply mipmapping.
     Texture1D(const float* pixelData, const GLsizei width, const bool linear, const bool anisotropy, const bool mipmap);
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Disallow asset move constructor.
-    Texture1D(Texture1D&&) noexcept = default;
+    /// \brief  Move constructor.
+    Texture1D(Texture1D&& o) noexcept { (*this) = std::move(o); }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Disallow asset move assignment.
-    Texture1D& operator=(Texture1D&&) noexcept = default;
+    /// \brief  Move assignment, swapping so the other texture releases this one's object.
+    Texture1D& operator=(Texture1D&& o) noexcept {
+        if (&o != this) {
+            std::swap(m_glTexID, o.m_glTexID);
+            std::swap(m_storageBytes, o.m_storageBytes);
+        }
+        return *this;
+    }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Makes this texture active at a specific texture unit.
@@ -44,7 +56,8 @@ class Texture1D {
 
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    GLuint m_glTexID = 0; ///< OpenGL texture object ID.
+    GLuint m_glTexID = 0;          ///< OpenGL texture object ID.
+    GLsizeiptr m_storageBytes = 0; ///< Byte-size of the texture storage.
 };
 }; // namespace mini
 
@@ -3,8 +3,10 @@
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
 using mini::Image;
+using mini::MemoryRegistry;
 using mini::Texture2D;
 constexpr auto MAX_ANISOTROPY = 16.0F;
+constexpr GLsizeiptr RGBA16F_TEXEL_BYTES = 8;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Constructor
@@ -16,6 +18,8 @@ Texture2D::Texture2D(
     // Create Texture & storage
     glCreateTextures(GL_TEXTURE_2D, 1, &m_glTexID);
     glTextureStorage2D(m_glTexID, 1, GL_RGBA16F, width, height);
+    m_storageBytes = static_cast<GLsizeiptr>(width) * static_cast<GLsizeiptr>(height) * RGBA16F_TEXEL_BYTES;
+    MemoryRegistry::Allocate(MemoryRegistry::Category::Texture, m_storageBytes);
 
     // Load Texture
     glTextureSubImage2D(m_glTexID, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, pixelData);
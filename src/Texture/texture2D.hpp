@@ -3,7 +3,9 @@
 #define MINIGFX_TEXTURE2D_HPP
 
 #include "Texture/image.hpp"
+#include "Utility/memoryRegistry.hpp"
 #include <glad/glad.h>
+#include <utility>
 
 namespace mini {
 //////////////////////////////////////////////////////////////////////
@@ -13,7 +15,11 @@ class Texture2D {
     public:
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy the Texture.
-    ~Texture2D() { glDeleteTextures(1, &m_glTexID); }
+    ~Texture2D() {
+        if (m_glTexID != 0U)
+            MemoryRegistry::Free(MemoryRegistry::Category::Texture, m_storageBytes);
+        glDeleteTextures(1, &m_glTexID);
+    }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Construct a Texture with a given size and data.
     /// \param  pixelData       the image pixels.
@@ -33,12 +39,18 @@ class Texture2D {
     /// \param  mipmap          whether to apply mipmapping.
     Texture2D(const Image& image, const bool linear, const bool anisotropy, const bool mipmap);
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default move constructor.
-    Texture2D(Texture2D&&) noexcept = default;
+    /// \brief  Move constructor.
+    Texture2D(Texture2D&& o) noexcept { (*this) = std::move(o); }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default asset move assignment.
-    Texture2D& operator=(Texture2D&&) noexcept = default;
+    /// \brief  Move assignment, swapping so the other texture releases this one's object.
+    Texture2D& operator=(Texture2D&& o) noexcept {
+        if (&o != this) {
+            std::swap(m_glTexID, o.m_glTexID);
+            std::swap(m_storageBytes, o.m_storageBytes);
+        }
+        return *this;
+    }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Makes this texture active at a specific texture unit.
@@ -55,7 +67,8 @@ class Texture2D {
 
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    GLuint m_glTexID = 0; ///< OpenGL texture object ID.
+    GLuint m_glTexID = 0;          ///< OpenGL texture object ID.
+    GLsizeiptr m_storageBytes = 0; ///< Byte-size of the texture storage.
 };
 }; // namespace mini
 
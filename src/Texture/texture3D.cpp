@@ -2,8 +2,10 @@
 
 //////////////////////////////////////////////////////////////////////
 /// Useful Aliases
+using mini::MemoryRegistry;
 using mini::Texture3D;
 constexpr auto MAX_ANISOTROPY = 16.0F;
+constexpr GLsizeiptr RGBA16F_TEXEL_BYTES = 8;
 
 //////////////////////////////////////////////////////////////////////
 /// Custom Constructor
@@ -15,6 +17,9 @@ Texture3D::Texture3D(
     // Create Texture & storage
     glCreateTextures(GL_TEXTURE_3D, 1, &m_glTexID);
     glTextureStorage3D(m_glTexID, 1, GL_RGBA16F, width, height, depth);
+    m_storageBytes = static_cast<GLsizeiptr>(width) * static_cast<GLsizeiptr>(height) *
+                     static_cast<GLsizeiptr>(depth) * RGBA16F_TEXEL_BYTES;
+    MemoryRegistry::Allocate(MemoryRegistry::Category::Texture, m_storageBytes);
 
     // Load Texture
     glTextureSubImage3D(m_glTexID, 0, 0, 0, 0, width, height, depth, GL_RGBA, GL_FLOAT, pixelData);
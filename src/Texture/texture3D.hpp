@@ -2,7 +2,9 @@
 #ifndef MINIGFX_TEXTURE3D_HPP
 #define MINIGFX_TEXTURE3D_HPP
 
+#include "Utility/memoryRegistry.hpp"
 #include <glad/glad.h>
+#include <utility>
 
 namespace mini {
 //////////////////////////////////////////////////////////////////////
@@ -12,7 +14,11 @@ class Texture3D {
     public:
     //////////////////////////////////////////////////////////////////////
     /// \brief  Destroy the Texture.
-    ~Texture3D() { glDeleteTextures(1, &m_glTexID); }
+    ~Texture3D() {
+        if (m_glTexID != 0U)
+            MemoryRegistry::Free(MemoryRegistry::Category::Texture, m_storageBytes);
+        glDeleteTextures(1, &m_glTexID);
+    }
     //////////////////////////////////////////////////////////////////////
     /// \brief  Construct a Texture with a given size and data.
     /// \param  pixelData       the image pixels.
@@ -26,12 +32,18 @@ class Texture3D {
         const float* pixelData, const GLsizei width, const GLsizei depth, const GLsizei height, const bool linear,
         const bool anisotropy, const bool mipmap);
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default asset move constructor.
-    Texture3D(Texture3D&&) noexcept = default;
+    /// \brief  Move constructor.
+    Texture3D(Texture3D&& o) noexcept { (*this) = std::move(o); }
 
     //////////////////////////////////////////////////////////////////////
-    /// \brief  Default asset move assignment.
-    Texture3D& operator=(Texture3D&&) noexcept = default;
+    /// \brief  Move assignment, swapping so the other texture releases this one's object.
+    Texture3D& operator=(Texture3D&& o) noexcept {
+        if (&o != this) {
+            std::swap(m_glTexID, o.m_glTexID);
+            std::swap(m_storageBytes, o.m_storageBytes);
+        }
+        return *this;
+    }
 
     //////////////////////////////////////////////////////////////////////
     /// \brief  Makes this texture active at a specific texture unit.
@@ -48,7 +60,8 @@ class Texture3D {
 
     //////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    GLuint m_glTexID = 0; ///< OpenGL texture object ID.
+    GLuint m_glTexID = 0;          ///< OpenGL texture object ID.
+    GLsizeiptr m_storageBytes = 0; ///< Byte-size of the texture storage.
 };
 }; // namespace mini
 
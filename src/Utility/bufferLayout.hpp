@@ -0,0 +1,254 @@
+#pragma once
+#ifndef MINIGFX_BUFFERLAYOUT_HPP
+#define MINIGFX_BUFFERLAYOUT_HPP
+
+#include "Utility/mat.hpp"
+#include "Utility/vec.hpp"
+#include <array>
+#include <cstring>
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \brief  The GLSL block layout rules a BufferLayout can follow.
+enum class LayoutRule {
+    Std140, ///< Uniform block layout, arrays and structs aligned to 16 bytes.
+    Std430  ///< Storage block layout, arrays and structs aligned to their elements.
+};
+
+template <LayoutRule Rule, typename... Fields> class BufferLayout;
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Size and base alignment of a GLSL basic type, in bytes.
+/// \note   Only 4-byte components are supported, as GLSL doubles are rarely used here.
+template <typename T> struct LayoutTraits;
+template <> struct LayoutTraits<float> {
+    static constexpr size_t Size = 4;      ///< Bytes occupied.
+    static constexpr size_t Alignment = 4; ///< Base alignment.
+};
+template <> struct LayoutTraits<int> : LayoutTraits<float> {};
+template <> struct LayoutTraits<unsigned int> : LayoutTraits<float> {};
+template <typename D> struct LayoutTraits<tvec2<D>> {
+    static_assert(sizeof(D) == 4, "only 4-byte vector components are supported");
+    static constexpr size_t Size = 8;      ///< Bytes occupied.
+    static constexpr size_t Alignment = 8; ///< Base alignment.
+};
+template <typename D> struct LayoutTraits<tvec3<D>> {
+    static_assert(sizeof(D) == 4, "only 4-byte vector components are supported");
+    static constexpr size_t Size = 12;      ///< Bytes occupied, the padding after may hold a scalar.
+    static constexpr size_t Alignment = 16; ///< Base alignment.
+};
+template <typename D> struct LayoutTraits<tvec4<D>> {
+    static_assert(sizeof(D) == 4, "only 4-byte vector components are supported");
+    static constexpr size_t Size = 16;      ///< Bytes occupied.
+    static constexpr size_t Alignment = 16; ///< Base alignment.
+};
+template <> struct LayoutTraits<mat4> {
+    static constexpr size_t Size = 64;      ///< Four vec4 columns, identical in both rules.
+    static constexpr size_t Alignment = 16; ///< Base alignment.
+};
+
+namespace detail {
+//////////////////////////////////////////////////////////////////////
+/// \brief  Round a value up to a multiple of an alignment.
+constexpr size_t layout_align(const size_t value, const size_t alignment) noexcept {
+    return ((value + alignment - 1) / alignment) * alignment;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Placement of a single member within a block.
+template <typename T, LayoutRule Rule> struct FieldLayout {
+    using Element = T;                                                   ///< The type of each element.
+    static constexpr size_t Count = 0;                                   ///< Array length, 0 if not an array.
+    static constexpr size_t Alignment = LayoutTraits<T>::Alignment;      ///< Base alignment of the member.
+    static constexpr size_t Size = LayoutTraits<T>::Size;                ///< Bytes occupied by the member.
+    static constexpr size_t Stride = Size;                               ///< Distance between elements.
+};
+template <LayoutRule Rule, typename... Fields> struct FieldLayout<BufferLayout<Rule, Fields...>, Rule> {
+    using Element = BufferLayout<Rule, Fields...>;                       ///< The nested block.
+    static constexpr size_t Count = 0;                                   ///< Array length, 0 if not an array.
+    static constexpr size_t Alignment = Element::Alignment;              ///< Base alignment of the member.
+    static constexpr size_t Size = Element::Size;                        ///< Bytes occupied by the member.
+    static constexpr size_t Stride = Size;                               ///< Distance between elements.
+};
+template <typename T, size_t N, LayoutRule Rule> struct FieldLayout<std::array<T, N>, Rule> {
+    static_assert(N > 0, "arrays must have at least one element");
+    using Element = T;                                                   ///< The type of each element.
+    static constexpr size_t Count = N;                                   ///< Array length.
+    static constexpr size_t Alignment = Rule == LayoutRule::Std140
+                                            ? layout_align(FieldLayout<T, Rule>::Alignment, 16)
+                                            : FieldLayout<T, Rule>::Alignment; ///< Base alignment of the array.
+    static constexpr size_t Stride =
+        layout_align(FieldLayout<T, Rule>::Size, Alignment);             ///< Distance between elements.
+    static constexpr size_t Size = Stride * N;                           ///< Bytes occupied by the array.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Compute the offset of every member of a block.
+template <LayoutRule Rule, typename... Fields> constexpr std::array<size_t, sizeof...(Fields)> layout_offsets() {
+    std::array<size_t, sizeof...(Fields)> offsets{};
+    size_t cursor = 0;
+    size_t index = 0;
+    ((cursor = layout_align(cursor, FieldLayout<Fields, Rule>::Alignment), offsets[index++] = cursor,
+      cursor += FieldLayout<Fields, Rule>::Size),
+     ...);
+    return offsets;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Compute the base alignment of a block.
+template <LayoutRule Rule, typename... Fields> constexpr size_t layout_alignment() {
+    size_t alignment = 4;
+    ((alignment = alignment < FieldLayout<Fields, Rule>::Alignment ? FieldLayout<Fields, Rule>::Alignment : alignment),
+     ...);
+    return Rule == LayoutRule::Std140 ? layout_align(alignment, 16) : alignment;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  Compute the size of a block, padded to its alignment.
+template <LayoutRule Rule, typename... Fields> constexpr size_t layout_size() {
+    size_t cursor = 0;
+    ((cursor = layout_align(cursor, FieldLayout<Fields, Rule>::Alignment) + FieldLayout<Fields, Rule>::Size), ...);
+    return layout_align(cursor, layout_alignment<Rule, Fields...>());
+}
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////
+/// \class  BufferLayout
+/// \brief  Describes the members of a GLSL uniform or storage block, computing
+///         their std140 or std430 offsets at compile time.
+/// \note   Members may be basic types, vectors, mat4, nested layouts of the same
+///         rule, or std::array of any of those.
+template <LayoutRule Rule, typename... Fields> class BufferLayout {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the type of a member.
+    template <size_t I> using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the placement of a member.
+    template <size_t I> using Field = detail::FieldLayout<FieldType<I>, Rule>;
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the byte offset of a member.
+    /// \return the member's offset from the start of the block.
+    template <size_t I> static constexpr size_t OffsetOf() noexcept {
+        return detail::layout_offsets<Rule, Fields...>()[I];
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Public Attributes
+    static constexpr size_t FieldCount = sizeof...(Fields);                             ///< Number of members.
+    static constexpr size_t Alignment = detail::layout_alignment<Rule, Fields...>();   ///< Block alignment.
+    static constexpr size_t Size = detail::layout_size<Rule, Fields...>();             ///< Block size, padded.
+};
+
+//////////////////////////////////////////////////////////////////////
+/// \brief  A uniform block layout.
+template <typename... Fields> using Std140Layout = BufferLayout<LayoutRule::Std140, Fields...>;
+//////////////////////////////////////////////////////////////////////
+/// \brief  A storage block layout.
+template <typename... Fields> using Std430Layout = BufferLayout<LayoutRule::Std430, Fields...>;
+
+//////////////////////////////////////////////////////////////////////
+/// \class  LayoutView
+/// \brief  Reads and writes the members of a block directly in mapped memory,
+///         at the offsets its BufferLayout dictates.
+template <typename Layout> class LayoutView {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a view of a block.
+    /// \param  base    pointer to the start of the block, e.g. into a mapped buffer.
+    explicit LayoutView(void* base) noexcept : m_base(static_cast<unsigned char*>(base)) {}
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a view of one block in a tightly packed array of blocks.
+    /// \param  base    pointer to the start of the array.
+    /// \param  index   the block to view.
+    /// \return a view of the block.
+    static LayoutView At(void* base, const size_t index) noexcept {
+        return LayoutView(static_cast<unsigned char*>(base) + (index * Layout::Size));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write a non-array member.
+    /// \param  value   the value to write.
+    template <size_t I> void set(const typename Layout::template FieldType<I>& value) noexcept {
+        static_assert(Layout::template Field<I>::Count == 0, "use the element overload for arrays");
+        copy_in(m_base + Layout::template OffsetOf<I>(), value);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write one element of an array member.
+    /// \param  element the array element to write.
+    /// \param  value   the value to write.
+    template <size_t I>
+    void set(const size_t element, const typename Layout::template Field<I>::Element& value) noexcept {
+        static_assert(Layout::template Field<I>::Count != 0, "member is not an array");
+        copy_in(element_address<I>(element), value);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Write a whole array member, re-striding it on the way.
+    /// \param  values  the values to write.
+    template <size_t I> void setArray(const typename Layout::template FieldType<I>& values) noexcept {
+        static_assert(Layout::template Field<I>::Count != 0, "member is not an array");
+        for (size_t x = 0; x < Layout::template Field<I>::Count; ++x)
+            copy_in(element_address<I>(x), values[x]);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Read a non-array member.
+    /// \return the member's value.
+    template <size_t I> typename Layout::template FieldType<I> get() const noexcept {
+        static_assert(Layout::template Field<I>::Count == 0, "use the element overload for arrays");
+        typename Layout::template FieldType<I> value;
+        copy_out(m_base + Layout::template OffsetOf<I>(), value);
+        return value;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Read one element of an array member.
+    /// \param  element the array element to read.
+    /// \return the element's value.
+    template <size_t I> typename Layout::template Field<I>::Element get(const size_t element) const noexcept {
+        static_assert(Layout::template Field<I>::Count != 0, "member is not an array");
+        typename Layout::template Field<I>::Element value;
+        copy_out(element_address<I>(element), value);
+        return value;
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  View a nested block member, or one element of an array of them.
+    /// \param  element the array element to view, 0 for a non-array member.
+    /// \return a view of the nested block.
+    template <size_t I> LayoutView<typename Layout::template Field<I>::Element> nested(const size_t element = 0) const
+        noexcept {
+        return LayoutView<typename Layout::template Field<I>::Element>(element_address<I>(element));
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the start of the viewed block.
+    /// \return pointer to the block.
+    void* data() const noexcept { return m_base; }
+
+    private:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compute the address of an array element.
+    template <size_t I> unsigned char* element_address(const size_t element) const noexcept {
+        return m_base + Layout::template OffsetOf<I>() + (element * Layout::template Field<I>::Stride);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a value into the block, without its trailing padding.
+    template <typename T> static void copy_in(unsigned char* destination, const T& value) noexcept {
+        static_assert(sizeof(T) == LayoutTraits<T>::Size, "type is not tightly packed");
+        std::memcpy(destination, &value, LayoutTraits<T>::Size);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a value out of the block.
+    template <typename T> static void copy_out(const unsigned char* source, T& value) noexcept {
+        static_assert(sizeof(T) == LayoutTraits<T>::Size, "type is not tightly packed");
+        std::memcpy(&value, source, LayoutTraits<T>::Size);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    unsigned char* m_base = nullptr; ///< The start of the viewed block.
+};
+}; // namespace mini
+
+#endif // MINIGFX_BUFFERLAYOUT_HPP
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "Utility/memoryRegistry.hpp"
+#include <atomic>
+#include <mutex>
+
+//////////////////////////////////////////////////////////////////////
+/// Useful Aliases
+using mini::MemoryRegistry;
+using Category = MemoryRegistry::Category;
+constexpr int CategoryCount = static_cast<int>(Category::Count);
+
+//////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+static void raise_peak(std::atomic<int64_t>& /*peak*/, const int64_t /*value*/) noexcept;
+
+//////////////////////////////////////////////////////////////////////
+/// Counter Storage
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+struct AtomicCounters {
+    std::atomic<int64_t> liveBytes{ 0 };
+    std::atomic<int64_t> peakBytes{ 0 };
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> frees{ 0 };
+    std::atomic<uint64_t> reallocations{ 0 };
+    std::atomic<uint64_t> bytesCopied{ 0 };
+    std::atomic<uint64_t> maps{ 0 };
+    std::atomic<uint64_t> unmaps{ 0 };
+};
+
+struct Registry {
+    AtomicCounters categories[CategoryCount];
+    std::atomic<int64_t> totalLiveBytes{ 0 };
+    std::atomic<int64_t> totalPeakBytes{ 0 };
+    std::mutex frameMutex;              ///< Guards lastFrame.
+    MemoryRegistry::Snapshot lastFrame; ///< The snapshot taken by the previous FrameDelta.
+};
+
+Registry& registry() noexcept {
+    static Registry s_registry;
+    return s_registry;
+}
+
+AtomicCounters& counters(const Category category) noexcept {
+    return registry().categories[static_cast<int>(category)];
+}
+
+void adjust_live(const Category category, const int64_t delta) noexcept {
+    auto& category_counters = counters(category);
+    raise_peak(category_counters.peakBytes, category_counters.liveBytes.fetch_add(delta) + delta);
+    raise_peak(registry().totalPeakBytes, registry().totalLiveBytes.fetch_add(delta) + delta);
+}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+/// Allocate
+//////////////////////////////////////////////////////////////////////
+
+void MemoryRegistry::Allocate(const Category category, const GLsizeiptr bytes) noexcept {
+    counters(category).allocations.fetch_add(1, std::memory_order_relaxed);
+    adjust_live(category, static_cast<int64_t>(bytes));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Free
+//////////////////////////////////////////////////////////////////////
+
+void MemoryRegistry::Free(const Category category, const GLsizeiptr bytes) noexcept {
+    counters(category).frees.fetch_add(1, std::memory_order_relaxed);
+    adjust_live(category, -static_cast<int64_t>(bytes));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Reallocate
+//////////////////////////////////////////////////////////////////////
+
+void MemoryRegistry::Reallocate(
+    const Category category, const GLsizeiptr newBytes, const GLsizeiptr copiedBytes) noexcept {
+    auto& category_counters = counters(category);
+    category_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    category_counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+    category_counters.bytesCopied.fetch_add(static_cast<uint64_t>(copiedBytes), std::memory_order_relaxed);
+    adjust_live(category, static_cast<int64_t>(newBytes));
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Map
+//////////////////////////////////////////////////////////////////////
+
+void MemoryRegistry::Map(const Category category) noexcept {
+    counters(category).maps.fetch_add(1, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Unmap
+//////////////////////////////////////////////////////////////////////
+
+void MemoryRegistry::Unmap(const Category category) noexcept {
+    counters(category).unmaps.fetch_add(1, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// TakeSnapshot
+//////////////////////////////////////////////////////////////////////
+
+MemoryRegistry::Snapshot MemoryRegistry::TakeSnapshot() noexcept {
+    Snapshot snapshot;
+    for (int x = 0; x < CategoryCount; ++x) {
+        const auto& source = registry().categories[x];
+        auto& target = snapshot.categories[x];
+        target.liveBytes = source.liveBytes.load(std::memory_order_relaxed);
+        target.peakBytes = source.peakBytes.load(std::memory_order_relaxed);
+        target.allocations = source.allocations.load(std::memory_order_relaxed);
+        target.frees = source.frees.load(std::memory_order_relaxed);
+        target.reallocations = source.reallocations.load(std::memory_order_relaxed);
+        target.bytesCopied = source.bytesCopied.load(std::memory_order_relaxed);
+        target.maps = source.maps.load(std::memory_order_relaxed);
+        target.unmaps = source.unmaps.load(std::memory_order_relaxed);
+    }
+    snapshot.totalLiveBytes = registry().totalLiveBytes.load(std::memory_order_relaxed);
+    snapshot.totalPeakBytes = registry().totalPeakBytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// FrameDelta
+//////////////////////////////////////////////////////////////////////
+
+MemoryRegistry::Snapshot MemoryRegistry::FrameDelta() noexcept {
+    const auto current = TakeSnapshot();
+    std::lock_guard<std::mutex> lock(registry().frameMutex);
+    const auto& last = registry().lastFrame;
+    auto delta = current;
+    for (int x = 0; x < CategoryCount; ++x) {
+        auto& target = delta.categories[x];
+        const auto& previous = last.categories[x];
+        target.liveBytes -= previous.liveBytes;
+        target.allocations -= previous.allocations;
+        target.frees -= previous.frees;
+        target.reallocations -= previous.reallocations;
+        target.bytesCopied -= previous.bytesCopied;
+        target.maps -= previous.maps;
+        target.unmaps -= previous.unmaps;
+    }
+    delta.totalLiveBytes -= last.totalLiveBytes;
+    registry().lastFrame = current;
+    return delta;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// CategoryName
+//////////////////////////////////////////////////////////////////////
+
+const char* MemoryRegistry::CategoryName(const Category category) noexcept {
+    switch (category) {
+    case Category::StaticBuffer:
+        return "StaticBuffer";
+    case Category::DynamicBuffer:
+        return "DynamicBuffer";
+    case Category::Vector:
+        return "Vector";
+    case Category::MultiBuffer:
+        return "MultiBuffer";
+    case Category::RingBuffer:
+        return "RingBuffer";
+    case Category::BufferHeap:
+        return "BufferHeap";
+    case Category::Readback:
+        return "Readback";
+    case Category::Model:
+        return "Model";
+    case Category::ModelGroup:
+        return "ModelGroup";
+    case Category::Texture:
+        return "Texture";
+    default:
+        return "Unknown";
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// raise_peak
+//////////////////////////////////////////////////////////////////////
+
+static void raise_peak(std::atomic<int64_t>& peak, const int64_t value) noexcept {
+    auto current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#ifndef MINIGFX_MEMORYREGISTRY_HPP
+#define MINIGFX_MEMORYREGISTRY_HPP
+
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace mini {
+//////////////////////////////////////////////////////////////////////
+/// \class  MemoryRegistry
+/// \brief  Process-wide accounting of the GPU memory held by every resource class.
+/// \note   All counters are lock-free, reporting is safe from any thread.
+class MemoryRegistry {
+    public:
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  The kinds of resource memory is accounted against.
+    enum class Category : int {
+        StaticBuffer,  ///< glStaticBuffer storage.
+        DynamicBuffer, ///< glDynamicBuffer storage.
+        Vector,        ///< glVector storage.
+        MultiBuffer,   ///< Storage of every multi-buffer slot.
+        RingBuffer,    ///< glRingBuffer and staging storage.
+        BufferHeap,    ///< glBufferHeap storage.
+        Readback,      ///< Pooled readback storage.
+        Model,         ///< Model vertex storage.
+        ModelGroup,    ///< ModelGroup vertex storage.
+        Texture,       ///< Texture storage.
+        Count          ///< Number of categories.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  The accumulated counters of a single category.
+    struct Counters {
+        int64_t liveBytes = 0;         ///< Bytes currently allocated.
+        int64_t peakBytes = 0;         ///< The most bytes ever allocated at once.
+        uint64_t allocations = 0ULL;   ///< Number of storage allocations.
+        uint64_t frees = 0ULL;         ///< Number of storage deallocations.
+        uint64_t reallocations = 0ULL; ///< Allocations that replaced storage to grow or shrink.
+        uint64_t bytesCopied = 0ULL;   ///< Bytes copied from old storage into replacements.
+        uint64_t maps = 0ULL;          ///< Number of buffer map events.
+        uint64_t unmaps = 0ULL;        ///< Number of buffer unmap events.
+    };
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  A copy of every category's counters at one point in time.
+    struct Snapshot {
+        Counters categories[static_cast<int>(Category::Count)]; ///< Counters per category.
+        int64_t totalLiveBytes = 0;                             ///< Bytes currently allocated, across categories.
+        int64_t totalPeakBytes = 0;                             ///< The most bytes ever allocated at once.
+
+        //////////////////////////////////////////////////////////////////////
+        /// \brief  Retrieve the counters of a category.
+        /// \param  category    the category to look up.
+        /// \return the category's counters.
+        const Counters& operator[](const Category category) const noexcept {
+            return categories[static_cast<int>(category)];
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record new storage.
+    /// \param  category    the category to account against.
+    /// \param  bytes       the size of the storage.
+    static void Allocate(const Category category, const GLsizeiptr bytes) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record storage being released.
+    /// \param  category    the category to account against.
+    /// \param  bytes       the size of the storage.
+    static void Free(const Category category, const GLsizeiptr bytes) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record new storage replacing older storage.
+    /// \note   The replacement counts as an allocation. The replaced storage stays live until passed to Free(),
+    ///         which retired storage only is once the GPU is done with it.
+    /// \param  category    the category to account against.
+    /// \param  newBytes    the size of the replacement.
+    /// \param  copiedBytes how many bytes were carried over.
+    static void Reallocate(const Category category, const GLsizeiptr newBytes, const GLsizeiptr copiedBytes) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record a buffer being mapped.
+    /// \param  category    the category to account against.
+    static void Map(const Category category) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Record a buffer being unmapped.
+    /// \param  category    the category to account against.
+    static void Unmap(const Category category) noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Copy every counter.
+    /// \return the current counters.
+    static Snapshot TakeSnapshot() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Compute how every counter changed since the last call.
+    /// \note   Call once per frame. Live bytes become a signed delta, peaks stay absolute.
+    /// \return the change in each counter.
+    static Snapshot FrameDelta() noexcept;
+    //////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the name of a category.
+    /// \param  category    the category to name.
+    /// \return the category's name.
+    static const char* CategoryName(const Category category) noexcept;
+};
+}; // namespace mini
+
+#endif // MINIGFX_MEMORYREGISTRY_HPP
\ No newline at end of file